@@ -10,3 +10,4 @@
 #include "Abortable.h"
 
 volatile bool Abortable::global_abort_ = false;
+COMPAT_THREAD_LOCAL const volatile bool *Abortable::current_abort_ = NULL;
@@ -10,23 +10,58 @@
 #ifndef ABORTABLE_H_INCLUDED
 #define ABORTABLE_H_INCLUDED
 
+#include <stddef.h>
+
+#include "compatibility.h"
+
 /*! Mix-in class for classes whose operations can be aborted asynchronously.
 
     Classes inheriting Abortable should periodically check whether they are
     aborted by calling aborted() in time-consuming procedures.
+
+    Besides aborting all instances at once with abort_all(), instances can be
+    cancelled in groups: each instance observes the abort flag of the Scope
+    that was active in the constructing thread (if any), so a solver created
+    inside a scope is cancelled together with all subsolvers it creates.
 */
 class Abortable
 {
 public:
+    /*! Activates an abort flag for all instances constructed by the current
+        thread during the lifetime of the scope object. Scopes may be nested;
+        the innermost one applies. */
+    class Scope
+    {
+    public:
+        explicit Scope(const volatile bool *abort)
+            : prev_(current_abort_) { current_abort_ = abort; }
+        ~Scope() { current_abort_ = prev_; }
+
+    private:
+        Scope(const Scope &);
+        Scope &operator=(const Scope &);
+
+        const volatile bool *prev_;  //!< flag of the enclosing scope
+    };
+
+    //! Constructs an instance observing the abort flag of the current scope.
+    Abortable() : abort_(current_abort_) { }
+
     //! Abort all abortable processes.
     static void abort_all() { global_abort_ = true; }
 
     //! Returns whether this instance has been aborted.
-    bool aborted() { return global_abort_; }
+    bool aborted() { return global_abort_ || (abort_ != NULL && *abort_); }
 
 private:
     //! Global variable indicating whether the process has been aborted.
     static volatile bool global_abort_;
+
+    //! Abort flag of the innermost Scope in the current thread (or NULL).
+    static COMPAT_THREAD_LOCAL const volatile bool *current_abort_;
+
+    //! Abort flag of the scope in which this instance was constructed.
+    const volatile bool *abort_;
 };
 
 #endif /* ndef ABORTABLE_H_INCLUDED */
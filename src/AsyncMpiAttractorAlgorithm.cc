@@ -14,7 +14,7 @@ AsyncMpiAttractorImpl::AsyncMpiAttractorImpl( const VertexPartition &vpart,
         const GamePart &part, ParityGame::Player player,
         DenseSet<verti> &attr, std::deque<verti> &queue,
         ParityGame::Strategy &strategy )
-    : MpiTermination(1, MPI_INT, &vertex_val), vpart_(vpart), part(part),
+    : MpiTermination(1, MPI_VERTI, &vertex_val), vpart_(vpart), part(part),
       player(player), attr(attr), queue(queue), strategy_(strategy)
 {
 }
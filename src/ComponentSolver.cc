@@ -13,11 +13,19 @@
 #include <assert.h>
 #include <memory>
 
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
+
 ComponentSolver::ComponentSolver(
     const ParityGame &game, ParityGameSolverFactory &pgsf,
-    int max_depth, const verti *vmap, verti vmap_size )
+    int max_depth, const verti *vmap, verti vmap_size, bool parallel )
     : ParityGameSolver(game), pgsf_(pgsf), max_depth_(max_depth),
-      vmap_(vmap), vmap_size_(vmap_size)
+      vmap_(vmap), vmap_size_(vmap_size), attractor_(NULL),
+      parallel_(parallel)
+#ifdef WITH_THREADS
+      , parallel_attractor_(NULL)
+#endif
 {
     pgsf_.ref();
 }
@@ -32,11 +40,33 @@ ParityGame::Strategy ComponentSolver::solve()
     verti V = game_.graph().V();
     strategy_.assign(V, NO_VERTEX);
     DenseSet<verti> W0(0, V), W1(0, V);
+    AttractorContext attractor(V);
     winning_[0] = &W0;
     winning_[1] = &W1;
+    attractor_ = &attractor;
+#ifdef WITH_THREADS
+    /* When components are solved one at a time, attractor sets can be
+       computed with all available threads instead. */
+    std::auto_ptr<ParallelAttractorContext> parallel_attractor;
+    if ( !parallel_ && !omp_in_parallel() && omp_get_max_threads() > 1 &&
+         game_.graph().edge_dir() == StaticGraph::EDGE_BIDIRECTIONAL )
+    {
+        parallel_attractor.reset(new ParallelAttractorContext(V));
+        parallel_attractor_ = parallel_attractor.get();
+    }
+    if (parallel_ && !omp_in_parallel())
+    {
+        if (solve_parallel() != 0) strategy_.clear();
+    }
+    else
+#endif
     if (decompose_graph(game_.graph(), *this) != 0) strategy_.clear();
     winning_[0] = NULL;
     winning_[1] = NULL;
+    attractor_ = NULL;
+#ifdef WITH_THREADS
+    parallel_attractor_ = NULL;
+#endif
     ParityGame::Strategy result;
     result.swap(strategy_);
     return result;
@@ -46,10 +76,26 @@ int ComponentSolver::operator()(const verti *vertices, size_t num_vertices)
 {
     if (aborted()) return -1;
 
+    std::vector<verti> unsolved;
+    get_unsolved(vertices, num_vertices, unsolved);
+    if (unsolved.empty()) return 0;
+
+    ParityGame subgame;
+    ParityGame::Strategy substrat;
+    if (!solve_component(unsolved, num_vertices, subgame, substrat))
+    {
+        return -1;  // solving failed
+    }
+    merge_component(unsolved, subgame, substrat);
+    return 0;
+}
+
+void ComponentSolver::get_unsolved( const verti *vertices, size_t num_vertices,
+                                    std::vector<verti> &unsolved )
+{
     assert(num_vertices > 0);
 
     // Filter out solved vertices:
-    std::vector<verti> unsolved;
     unsolved.reserve(num_vertices);
     for (size_t n = 0; n < num_vertices; ++n)
     {
@@ -61,18 +107,30 @@ int ComponentSolver::operator()(const verti *vertices, size_t num_vertices)
     }
     info("(ComponentSolver) SCC of size %ld with %ld unsolved vertices...",
          (long)num_vertices, (long)unsolved.size());
-    if (unsolved.empty()) return 0;
+}
 
+bool ComponentSolver::solve_component( const std::vector<verti> &unsolved,
+    size_t num_vertices, ParityGame &subgame, ParityGame::Strategy &substrat )
+{
     // Construct a subgame for unsolved vertices in this component:
-    ParityGame subgame;
     subgame.make_subgame(game_, unsolved.begin(), unsolved.end(), true);
 
-    ParityGame::Strategy substrat;
     if (max_depth_ > 0 && unsolved.size() < num_vertices)
     {
         info( "(ComponentSolver) Recursing on subgame of size %d...",
               (int)unsolved.size() );
-        ComponentSolver(subgame, pgsf_, max_depth_ - 1).solve().swap(substrat);
+        // Solver factories and solvers are reference counted, so creating
+        // and destroying them must be serialized when solving in parallel.
+        std::auto_ptr<ComponentSolver> subsolver;
+#ifdef WITH_THREADS
+        #pragma omp critical(ComponentSolver_refs)
+#endif
+        subsolver.reset(new ComponentSolver(subgame, pgsf_, max_depth_ - 1));
+        subsolver->solve().swap(substrat);
+#ifdef WITH_THREADS
+        #pragma omp critical(ComponentSolver_refs)
+#endif
+        subsolver.reset();
     }
     else
     {
@@ -97,18 +155,25 @@ int ComponentSolver::operator()(const verti *vertices, size_t num_vertices)
         {
             submap = unsolved;
             merge_vertex_maps(submap.begin(), submap.end(), vmap_, vmap_size_);
-            subsolver.reset(
-                pgsf_.create(subgame, &submap[0], submap.size()) );
-        }
-        else
-        {
-            subsolver.reset(
-                pgsf_.create(subgame, &unsolved[0], unsolved.size()) );
         }
+        const std::vector<verti> &map = vmap_size_ > 0 ? submap : unsolved;
+
+#ifdef WITH_THREADS
+        #pragma omp critical(ComponentSolver_refs)
+#endif
+        subsolver.reset(pgsf_.create(subgame, &map[0], map.size()));
         subsolver->solve().swap(substrat);
+#ifdef WITH_THREADS
+        #pragma omp critical(ComponentSolver_refs)
+#endif
+        subsolver.reset();
     }
-    if (substrat.empty()) return -1;  // solving failed
+    return !substrat.empty();
+}
 
+void ComponentSolver::merge_component( const std::vector<verti> &unsolved,
+    const ParityGame &subgame, const ParityGame::Strategy &substrat )
+{
     info("(ComponentSolver) Merging strategies...");
     merge_strategies(strategy_, substrat, unsolved);
 
@@ -127,17 +192,142 @@ int ComponentSolver::operator()(const verti *vertices, size_t num_vertices)
     // Extend winning sets to attractor sets:
     for (int player = 0; player < 2; ++player)
     {
-        make_attractor_set( game_, (ParityGame::Player)player,
-                            *winning_[player], todo[player], strategy_ );
+#ifdef WITH_THREADS
+        if (parallel_attractor_)
+        {
+            std::vector<verti> frontier(todo[player].begin(),
+                                        todo[player].end());
+            parallel_attractor_->make_attractor_set( game_,
+                (ParityGame::Player)player, *winning_[player], frontier,
+                strategy_ );
+            continue;
+        }
+#endif
+        attractor_->make_attractor_set( game_, game_.graph(),
+            (ParityGame::Player)player, *winning_[player], todo[player],
+            strategy_ );
     }
 
     info("(ComponentSolver) Leaving.");
+}
+
+#ifdef WITH_THREADS
+int ComponentSolver::Schedule::operator()( const verti *vertices,
+                                           size_t num_vertices )
+{
+    const verti c = (verti)(start.size() - 1);
+    for (size_t n = 0; n < num_vertices; ++n) component[vertices[n]] = c;
+    this->vertices.insert(this->vertices.end(), vertices,
+                          vertices + num_vertices);
+    start.push_back(this->vertices.size());
     return 0;
 }
 
+int ComponentSolver::solve_parallel()
+{
+    const StaticGraph &graph = game_.graph();
+    const verti V = graph.V();
+
+    // Find components, which are numbered in reverse topological order:
+    Schedule schedule;
+    schedule.vertices.reserve(V);
+    schedule.start.push_back(0);
+    schedule.component.assign(V, NO_VERTEX);
+    schedule.failed = false;
+    decompose_graph(graph, schedule);
+    const verti C = (verti)(schedule.start.size() - 1);
+    info("(ComponentSolver) Solving %ld components in parallel...", (long)C);
+
+    // Count dependencies on other components:
+    schedule.pending.assign(C, 0);
+    for (verti v = 0; v < V; ++v)
+    {
+        const verti c = schedule.component[v];
+        for ( StaticGraph::const_iterator it = graph.succ_begin(v);
+              it != graph.succ_end(v); ++it )
+        {
+            if (schedule.component[*it] != c) ++schedule.pending[c];
+        }
+    }
+
+    // Solve components without dependencies first; solve_task() schedules
+    // the remaining components as they become ready.
+    schedule_ = &schedule;
+    #pragma omp parallel
+    #pragma omp single
+    for (verti c = 0; c < C; ++c)
+    {
+        if (schedule.pending[c] == 0)
+        {
+            #pragma omp task
+            solve_task(c);
+        }
+    }
+    schedule_ = NULL;
+
+    return schedule.failed ? -1 : 0;
+}
+
+void ComponentSolver::solve_task(verti c)
+{
+    Schedule &schedule = *schedule_;
+    if (schedule.failed) return;
+    if (aborted())
+    {
+        schedule.failed = true;
+        return;
+    }
+
+    const verti *vertices = &schedule.vertices[schedule.start[c]];
+    const size_t num_vertices = schedule.start[c + 1] - schedule.start[c];
+
+    /* Vertices in this component cannot be added to the winning sets while
+       it is being solved, because attractor sets only grow into components
+       that depend on the ones merged, which are not ready yet. The winning
+       sets are shared with concurrent merges, however, so access to them is
+       serialized. */
+    std::vector<verti> unsolved;
+    #pragma omp critical(ComponentSolver_merge)
+    get_unsolved(vertices, num_vertices, unsolved);
+
+    ParityGame subgame;
+    ParityGame::Strategy substrat;
+    if ( !unsolved.empty() &&
+         !solve_component(unsolved, num_vertices, subgame, substrat) )
+    {
+        schedule.failed = true;
+        return;
+    }
+
+    // Merge the solution and find components that have become ready:
+    std::vector<verti> ready;
+    #pragma omp critical(ComponentSolver_merge)
+    {
+        if (!unsolved.empty()) merge_component(unsolved, subgame, substrat);
+        for (size_t n = 0; n < num_vertices; ++n)
+        {
+            const verti v = vertices[n];
+            for ( StaticGraph::const_iterator it = game_.graph().pred_begin(v);
+                  it != game_.graph().pred_end(v); ++it )
+            {
+                const verti d = schedule.component[*it];
+                if (d != c && --schedule.pending[d] == 0) ready.push_back(d);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < ready.size(); ++i)
+    {
+        const verti d = ready[i];
+        #pragma omp task
+        solve_task(d);
+    }
+}
+#endif
+
 ParityGameSolver *ComponentSolverFactory::create( const ParityGame &game,
         const verti *vertex_map, verti vertex_map_size )
 {
-    return new ComponentSolver( game, pgsf_, max_depth_, 
-                                vertex_map, vertex_map_size );
+    return new ComponentSolver( game, pgsf_, max_depth_,
+                                vertex_map, vertex_map_size, parallel_ );
 }
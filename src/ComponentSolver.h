@@ -14,6 +14,7 @@
 #include "DenseSet.h"
 #include "Logger.h"
 #include "SCC.h"
+#include "attractor.h"
 #include <string>
 #include <vector>
 
@@ -35,10 +36,16 @@ public:
         recursively decomposed (up to the give depth) if it turns out they have
         been partially solved already (i.e. when some of their vertices lie in
         the attractor sets of winning regions identified earlier).
+
+        When `parallel` is true (and thread support is compiled in) components
+        are solved concurrently: each component is scheduled as soon as all
+        components it depends on have been solved and their attractor sets
+        merged into the winning sets. Subsolvers are then created, run and
+        destroyed concurrently, so they should not share mutable state.
     */
     ComponentSolver( const ParityGame &game, ParityGameSolverFactory &pgsf,
-                     int max_depth, const verti *vmap = 0, verti vmap_size = 0
-                   );
+                     int max_depth, const verti *vmap = 0, verti vmap_size = 0,
+                     bool parallel = false );
     ~ComponentSolver();
 
     ParityGame::Strategy solve();
@@ -47,6 +54,61 @@ private:
     // SCC callback
     int operator()(const verti *vertices, size_t num_vertices);
     friend class SCC<ComponentSolver>;
+#ifdef WITH_THREADS
+    friend class ParallelSCC<ComponentSolver>;
+#endif
+
+    /*! Collects the vertices in [vertices:vertices + num_vertices) that do
+        not belong to a winning set yet into `unsolved`. */
+    void get_unsolved( const verti *vertices, size_t num_vertices,
+                       std::vector<verti> &unsolved );
+
+    /*! Solves the subgame induced by the `unsolved` vertices of a component
+        of `num_vertices` vertices, storing the subgame and its strategy in
+        `subgame` and `substrat`. Returns whether solving succeeded. */
+    bool solve_component( const std::vector<verti> &unsolved,
+                          size_t num_vertices, ParityGame &subgame,
+                          ParityGame::Strategy &substrat );
+
+    /*! Merges the solution of a subgame into the resulting strategy, and
+        extends the winning sets with the attractor sets of the winning
+        regions of the subgame. */
+    void merge_component( const std::vector<verti> &unsolved,
+                          const ParityGame &subgame,
+                          const ParityGame::Strategy &substrat );
+
+#ifdef WITH_THREADS
+    /*! The components of the game graph and their dependencies, used to
+        schedule components when solving in parallel. */
+    struct Schedule
+    {
+        //! Vertices of all components, grouped by component.
+        std::vector<verti> vertices;
+
+        //! Index of the first vertex of each component (plus an end marker).
+        std::vector<size_t> start;
+
+        //! Component index of each vertex.
+        std::vector<verti> component;
+
+        //! Number of edges to unmerged components, for each component.
+        std::vector<edgei> pending;
+
+        //! Set when solving fails or is aborted.
+        volatile bool failed;
+
+        //! SCC callback: appends a component.
+        int operator()(const verti *vertices, size_t num_vertices);
+    };
+
+    /*! Solves components in parallel, in an order consistent with the
+        dependencies between them. Returns zero if successful. */
+    int solve_parallel();
+
+    /*! Solves component `c` and schedules the components that depend on
+        it once they become ready. Called as a task from solve_parallel(). */
+    void solve_task(verti c);
+#endif
 
 protected:
     ParityGameSolverFactory  &pgsf_;        //!< Solver factory to use
@@ -55,6 +117,12 @@ protected:
     const verti              vmap_size_;    //!< Size of vertex map
     ParityGame::Strategy     strategy_;     //!< Resulting strategy
     DenseSet<verti>          *winning_[2];  //!< Resulting winning sets
+    AttractorContext         *attractor_;   //!< Attractor set workspace
+    const bool               parallel_;     //!< Solve components in parallel
+#ifdef WITH_THREADS
+    Schedule                 *schedule_;    //!< Components to solve in parallel
+    ParallelAttractorContext *parallel_attractor_;  //!< Multithreaded workspace
+#endif
 };
 
 //! Factory class for ComponentSolver instances.
@@ -62,8 +130,10 @@ class ComponentSolverFactory : public ParityGameSolverFactory
 {
 public:
     //! \see ComponentSolver::ComponentSolver()
-    ComponentSolverFactory(ParityGameSolverFactory &pgsf, int max_depth = 10)
-        : pgsf_(pgsf), max_depth_(max_depth) { pgsf_.ref(); }
+    ComponentSolverFactory( ParityGameSolverFactory &pgsf, int max_depth = 10,
+                            bool parallel = false )
+        : pgsf_(pgsf), max_depth_(max_depth), parallel_(parallel)
+    { pgsf_.ref(); }
     ~ComponentSolverFactory() { pgsf_.deref(); }
 
     //! Return a new ComponentSolver instance.
@@ -73,6 +143,7 @@ public:
 protected:
     ParityGameSolverFactory &pgsf_;     //!< Factory used to create subsolvers
     const int max_depth_;               //!< Maximum recursion depth
+    const bool parallel_;               //!< Solve components in parallel
 };
 
 #endif /* ndef COMPONENT_SOLVER_H_INCLUDED */
@@ -0,0 +1,161 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#if defined(__unix__) || defined(__linux__)
+#define POSIX
+#endif
+
+#include "CompressedGraph.h"
+#include "Logger.h"
+#include <assert.h>
+#include <algorithm>
+#include <utility>
+
+#ifdef POSIX
+#include <unistd.h>
+#endif
+
+/*! Provides successor or predecessor lists of a StaticGraph to
+    CompressedGraph::Lists::assign(). */
+class StaticGraphLists
+{
+public:
+    StaticGraphLists(const StaticGraph &graph, bool successors)
+        : graph_(graph), successors_(successors) { }
+
+    std::pair<const verti*, const verti*> range(verti v)
+    {
+        return successors_
+            ? std::make_pair(graph_.succ_begin(v), graph_.succ_end(v))
+            : std::make_pair(graph_.pred_begin(v), graph_.pred_end(v));
+    }
+
+private:
+    const StaticGraph &graph_;
+    bool successors_;
+};
+
+//
+//  CompressedGraph::Lists
+//
+
+edgei CompressedGraph::Lists::count(verti v) const
+{
+    edgei res = 0;
+    for (const unsigned char *p = begin(v), *end = begin(v + 1); p != end; ++p)
+    {
+        if (!(*p & 0x80)) ++res;
+    }
+    return res;
+}
+
+void CompressedGraph::Lists::clear()
+{
+    delete[] data;
+    delete[] block;
+    delete[] offset;
+    data   = NULL;
+    block  = NULL;
+    offset = NULL;
+}
+
+size_t CompressedGraph::Lists::memory_use(verti V) const
+{
+    if (!data) return 0;
+    return (begin(V) - data + 1) + sizeof(*block)*((V >> block_bits) + 1)
+                                 + sizeof(*offset)*(V + 1);
+}
+
+
+//
+//  CompressedGraph
+//
+
+CompressedGraph::CompressedGraph()
+    : V_(0), E_(0), edge_dir_(StaticGraph::EDGE_NONE)
+{
+}
+
+CompressedGraph::~CompressedGraph()
+{
+    clear();
+}
+
+void CompressedGraph::clear()
+{
+    successors_.clear();
+    predecessors_.clear();
+    V_ = 0;
+    E_ = 0;
+    edge_dir_ = StaticGraph::EDGE_NONE;
+}
+
+void CompressedGraph::assign(const StaticGraph &graph, EdgeDirection edge_dir)
+{
+    if (edge_dir == StaticGraph::EDGE_NONE) edge_dir = graph.edge_dir();
+
+    if ((graph.edge_dir() & edge_dir) != edge_dir)
+    {
+        // Construct the missing edge direction first:
+        StaticGraph tmp;
+        tmp.assign(graph.get_edges(), edge_dir, graph.V());
+        assign(tmp, edge_dir);
+        return;
+    }
+
+    clear();
+    V_ = graph.V();
+    E_ = graph.E();
+    edge_dir_ = edge_dir;
+    if (edge_dir & StaticGraph::EDGE_SUCCESSOR)
+    {
+        StaticGraphLists lists(graph, true);
+        successors_.assign(V_, lists);
+    }
+    if (edge_dir & StaticGraph::EDGE_PREDECESSOR)
+    {
+        StaticGraphLists lists(graph, false);
+        predecessors_.assign(V_, lists);
+    }
+}
+
+void CompressedGraph::swap(CompressedGraph &g)
+{
+    std::swap(V_, g.V_);
+    std::swap(E_, g.E_);
+    std::swap(edge_dir_, g.edge_dir_);
+    std::swap(successors_, g.successors_);
+    std::swap(predecessors_, g.predecessors_);
+}
+
+size_t CompressedGraph::memory_use() const
+{
+    return successors_.memory_use(V_) + predecessors_.memory_use(V_);
+}
+
+size_t CompressedGraph::static_memory_use( verti V, edgei E,
+                                           EdgeDirection edge_dir )
+{
+    size_t per_dir = sizeof(verti)*E + sizeof(edgei)*(V + 1);
+    return per_dir*( ((edge_dir & StaticGraph::EDGE_SUCCESSOR)   != 0) +
+                     ((edge_dir & StaticGraph::EDGE_PREDECESSOR) != 0) );
+}
+
+bool CompressedGraph::preferred(verti V, edgei E, EdgeDirection edge_dir)
+{
+#if defined(POSIX) && defined(_SC_AVPHYS_PAGES)
+    long pages = sysconf(_SC_AVPHYS_PAGES), page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0)
+    {
+        return static_memory_use(V, E, edge_dir) > (size_t)pages*page_size;
+    }
+#endif
+    (void)V, (void)E, (void)edge_dir;
+    return false;
+}
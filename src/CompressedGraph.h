@@ -0,0 +1,283 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+/*! \file CompressedGraph.h
+
+    A read-only graph representation that stores adjacency lists compressed.
+*/
+
+#ifndef COMPRESSED_GRAPH_H_INCLUDED
+#define COMPRESSED_GRAPH_H_INCLUDED
+
+#include "Graph.h"
+#include <stddef.h>
+#include <iterator>
+
+/*! \ingroup ParityGameData
+
+    A static graph that stores its successor and/or predecessor lists in
+    compressed form, trading some speed for memory.
+
+    Each (sorted) adjacency list of a vertex `v` is encoded as a sequence of
+    differences between consecutive elements (where the first element is
+    relative to `v` itself), which are stored as variable-length integers
+    of 7 bits per byte. Since differences are usually small (especially after
+    reordering vertices in breadth-first order) most edges take up one byte.
+
+    The interface mirrors the data access part of StaticGraph, except that
+    iterators are forward iterators that decode elements on the fly, so
+    templated algorithms (like decompose_graph()) can be run on either
+    representation. Currently, only ParityGame::verify() uses it, for the
+    subgraphs it constructs when these would not fit in memory otherwise;
+    these are encoded from the game graph with assign_successors(), without
+    constructing an edge list first. */
+class CompressedGraph
+{
+public:
+    typedef StaticGraph::EdgeDirection EdgeDirection;
+
+    /*! Forward iterator that decodes a compressed adjacency list. */
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag   iterator_category;
+        typedef verti                       value_type;
+        typedef ptrdiff_t                   difference_type;
+        typedef const verti                 *pointer;
+        typedef const verti                 &reference;
+
+        const_iterator() : p_(NULL), value_(0) { }
+
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+
+        const_iterator &operator++()
+        {
+            while (*p_++ & 0x80) { }
+            value_ += decode(p_);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const const_iterator &it) const { return p_ == it.p_; }
+        bool operator!=(const const_iterator &it) const { return p_ != it.p_; }
+
+    private:
+        /*! Constructs an iterator at the encoded element at `p`, which is
+            relative to `base`. */
+        const_iterator(const unsigned char *p, verti base)
+            : p_(p), value_(base + decode(p)) { }
+
+        /*! Constructs an iterator at `p` without decoding (used for end
+            iterators, which must not be dereferenced). */
+        explicit const_iterator(const unsigned char *p) : p_(p), value_(0) { }
+
+        /*! Decodes the difference stored at `p` (without advancing `p`). */
+        static verti decode(const unsigned char *p)
+        {
+            verti z = *p & 0x7f;
+            for (int shift = 7; *p++ & 0x80; shift += 7)
+            {
+                z |= (verti)(*p & 0x7f) << shift;
+            }
+            return (z >> 1) ^ -(z & 1);  // undo zig-zag encoding
+        }
+
+        const unsigned char *p_;    //!< start of the current encoded element
+        verti value_;               //!< value of the current element
+
+        friend class CompressedGraph;
+    };
+
+    CompressedGraph();      /*!< Construct an empty compressed graph. */
+    ~CompressedGraph();     /*!< Destroy the compressed graph. */
+
+    /*! Reset to an empty graph. */
+    void clear();
+
+    /*! Reset the graph to a compressed copy of `graph`, storing the edges
+        in the given direction (by default, the same edges as `graph`). */
+    void assign( const StaticGraph &graph,
+                 EdgeDirection edge_dir = StaticGraph::EDGE_NONE );
+
+    /*! Reset the graph to `V` vertices and `E` edges, storing successors
+        only, which are encoded directly from `lists` so that no uncompressed
+        copy of the graph is needed. `lists.range(v)` must return a pair of
+        pointers delimiting the successors of vertex `v` in increasing order;
+        it is called twice for each vertex, and the returned range need only
+        remain valid until the next call. */
+    template<class ListT>
+    void assign_successors(verti V, edgei E, ListT &lists);
+
+    /*! Swaps the contents of this graph with another one. */
+    void swap(CompressedGraph &g);
+
+    /*! Returns the number of bytes used to store the graph. */
+    size_t memory_use() const;
+
+    /*! Returns the number of bytes a StaticGraph with `V` vertices and `E`
+        edges would use to store the given edge directions. */
+    static size_t static_memory_use(verti V, edgei E, EdgeDirection edge_dir);
+
+    /*! Returns whether a graph with `V` vertices and `E` edges should be
+        stored compressed, because it would not otherwise fit in the
+        physical memory that is currently available. */
+    static bool preferred(verti V, edgei E, EdgeDirection edge_dir);
+
+    //!\name Data access
+    //!@{
+
+    /*! Returns whether the graph is empty. */
+    bool empty() const { return V_ == 0; }
+
+    /*! Returns the number of vertices in the graph. */
+    verti V() const { return V_; }
+
+    /*! Returns the number of edges in the graph. */
+    edgei E() const { return E_; }
+
+    /*! Return direction of edges stored. */
+    EdgeDirection edge_dir() const { return edge_dir_; }
+
+    /*! Returns an iterator pointing to the first successor of vertex `v`. */
+    const_iterator succ_begin(verti v) const {
+        return const_iterator(successors_.begin(v), v);
+    }
+
+    /*! Returns an iterator pointing past the last successor of vertex `v`. */
+    const_iterator succ_end(verti v) const {
+        return const_iterator(successors_.begin(v + 1));
+    }
+
+    /*! Returns an iterator pointing to the first predecessor of vertex `v`. */
+    const_iterator pred_begin(verti v) const {
+        return const_iterator(predecessors_.begin(v), v);
+    }
+
+    /*! Returns an iterator pointing past the last predecessor of vertex `v`. */
+    const_iterator pred_end(verti v) const {
+        return const_iterator(predecessors_.begin(v + 1));
+    }
+
+    /*! Returns whether `v` has a successor `w`. */
+    bool has_succ(verti v, verti w) const {
+        return contains(succ_begin(v), succ_end(v), w);
+    }
+
+    /*! Returns whether `w` has a predecessor `v`. */
+    bool has_pred(verti w, verti v) const {
+        return contains(pred_begin(w), pred_end(w), v);
+    }
+
+    /*! Returns the degree for vertex `v`. */
+    edgei degree(verti v) const {
+        return indegree(v) + outdegree(v);
+    }
+
+    /*! Returns the outdegree for vertex `v`. */
+    edgei outdegree(verti v) const { return successors_.count(v); }
+
+    /*! Returns the indegree for vertex `v`. */
+    edgei indegree(verti v) const { return predecessors_.count(v); }
+
+    //!@}
+
+private:
+    /*! Compressed adjacency lists for all vertices in a graph. */
+    struct Lists
+    {
+        /*! Vertices are grouped in blocks of 2^block_bits. The offset of the
+            data for each block is stored as a size_t, and the offsets of
+            vertices within a block are stored relative to it, which takes
+            less memory than storing full offsets for all vertices. */
+        static const int block_bits = 6;
+
+        unsigned char       *data;      //!< encoded lists (plus a sentinel)
+        size_t              *block;     //!< data offsets of vertex blocks
+        compat_uint32_t     *offset;    //!< vertex offsets relative to block
+
+        Lists() : data(NULL), block(NULL), offset(NULL) { }
+
+        /*! Returns a pointer to the encoded list of vertex `v` (which may be
+            the number of vertices, to get a pointer to the end of the data).*/
+        const unsigned char *begin(verti v) const {
+            return data + block[v >> block_bits] + offset[v];
+        }
+
+        /*! Returns the number of elements in the list of vertex `v`. */
+        edgei count(verti v) const;
+
+        /*! Frees allocated memory. */
+        void clear();
+
+        /*! Encodes the lists of a graph with `V` vertices; the list for
+            vertex `v` is given by [begin(v):end(v)). */
+        template<class ListT>
+        void assign(verti V, ListT &lists);
+
+        /*! Returns the number of bytes used to store lists for `V` vertices.*/
+        size_t memory_use(verti V) const;
+
+        /*! Returns the zig-zag encoding of the difference `w` - `v`, which
+            maps small negative and positive differences to small unsigned
+            values. */
+        static verti zigzag(verti v, verti w)
+        {
+            verti d = w - v;
+            return (d << 1) ^ -(d >> (8*sizeof(verti) - 1));
+        }
+
+        /*! Returns the number of bytes required to store `z` as a varint. */
+        static size_t varint_size(verti z)
+        {
+            size_t n = 1;
+            while (z >= 0x80) z >>= 7, ++n;
+            return n;
+        }
+
+        /*! Stores `z` as a varint at `p` and returns a pointer past it. */
+        static unsigned char *varint_write(verti z, unsigned char *p)
+        {
+            while (z >= 0x80)
+            {
+                *p++ = (unsigned char)(z | 0x80);
+                z >>= 7;
+            }
+            *p++ = (unsigned char)z;
+            return p;
+        }
+    };
+
+    template<class ForwardIterator>
+    static bool contains(ForwardIterator it, ForwardIterator end, verti w)
+    {
+        while (it != end && *it < w) ++it;
+        return it != end && *it == w;
+    }
+
+    CompressedGraph(const CompressedGraph &graph);
+    CompressedGraph &operator=(const CompressedGraph &graph);
+
+private:
+    verti V_;                   //!< number of vertices
+    edgei E_;                   //!< number of edges
+    EdgeDirection edge_dir_;    //!< edge directions stored
+    Lists successors_;          //!< compressed successor lists
+    Lists predecessors_;        //!< compressed predecessor lists
+};
+
+#include "CompressedGraph_impl.h"
+
+#endif /* ndef COMPRESSED_GRAPH_H_INCLUDED */
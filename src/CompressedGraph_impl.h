@@ -0,0 +1,71 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Don't include this directly; include CompressedGraph.h instead!
+
+#include "Logger.h"
+#include <assert.h>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+template<class ListT>
+void CompressedGraph::Lists::assign(verti V, ListT &lists)
+{
+    clear();
+    const verti mask = ((verti)1 << block_bits) - 1;
+    block  = new size_t[(V >> block_bits) + 1];
+    offset = new compat_uint32_t[V + 1];
+
+    // First pass: compute offsets of encoded lists.
+    size_t pos = 0;
+    for (verti v = 0; v <= V; ++v)
+    {
+        if ((v & mask) == 0) block[v >> block_bits] = pos;
+        if (pos - block[v >> block_bits] > (compat_uint32_t)-1)
+        {
+            Logger::fatal("Adjacency lists too large to compress!");
+        }
+        offset[v] = (compat_uint32_t)(pos - block[v >> block_bits]);
+        if (v == V) break;
+
+        std::pair<const verti*, const verti*> r = lists.range(v);
+        for (verti prev = v; r.first != r.second; prev = *r.first++)
+        {
+            pos += varint_size(zigzag(prev, *r.first));
+        }
+    }
+
+    // Second pass: encode lists (followed by a sentinel that terminates
+    // decoding past the end of the last list).
+    data = new unsigned char[pos + 1];
+    unsigned char *p = data;
+    for (verti v = 0; v < V; ++v)
+    {
+        std::pair<const verti*, const verti*> r = lists.range(v);
+        assert(std::adjacent_find( r.first, r.second,
+                                   std::greater<verti>() ) == r.second);
+        for (verti prev = v; r.first != r.second; prev = *r.first++)
+        {
+            p = varint_write(zigzag(prev, *r.first), p);
+        }
+    }
+    assert(p == data + pos);
+    *p = 0;
+}
+
+template<class ListT>
+void CompressedGraph::assign_successors(verti V, edgei E, ListT &lists)
+{
+    clear();
+    V_ = V;
+    E_ = E;
+    edge_dir_ = StaticGraph::EDGE_SUCCESSOR;
+    successors_.assign(V_, lists);
+}
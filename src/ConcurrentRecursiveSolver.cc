@@ -15,75 +15,21 @@
 #include "attractor.h"
 #include <set>
 #include <assert.h>
-#include <tbb/concurrent_vector.h>
-#include <tbb/concurrent_queue.h>
 
-static std::vector<verti> concurrent_get_complement(
-    const std::vector< tbb::atomic<char> > &vertices )
+static std::vector<verti> get_complement( verti V,
+                                          const DenseSet<verti> &vertices )
 {
-    const verti V = (verti)vertices.size();
     std::vector<verti> res;
     for (verti v = 0; v < V; ++v)
     {
-        if (!vertices[v]) res.push_back(v);
+        if (!vertices.count(v)) res.push_back(v);
     }
     return res;
 }
 
-static bool is_subset_of(
-    StaticGraph::const_iterator it, StaticGraph::const_iterator end,
-    const std::vector< tbb::atomic<char> > &vertices)
-{
-    for (; it != end; ++it) if (!vertices[*it]) return false;
-    return true;
-}
-
-void concurrent_make_attractor_set(
-    const ParityGame &game, ParityGame::Player player,
-    std::vector< tbb::atomic<char> > &vertices,
-    tbb::concurrent_queue<verti> &todo,
-    Substrategy &strategy )
-{
-    const StaticGraph &graph = game.graph();
-
-    #pragma omp parallel
-    for (verti w; todo.try_pop(w); )
-    {
-        // Check all predecessors v of w:
-        for (StaticGraph::const_iterator it = graph.pred_begin(w);
-            it != graph.pred_end(w); ++it)
-        {
-            const verti v = *it;
-
-            // Skip predecessors that are already in the attractor set:
-            if (vertices[v]) continue;
-
-            if (game.player(v) == player)
-            {
-                // Store strategy for player-controlled vertex:
-                strategy[v] = w;
-            }
-            else  // opponent controls vertex
-            if (is_subset_of(graph.succ_begin(v), graph.succ_end(v), vertices))
-            {
-                // Store strategy for opponent-controlled vertex:
-                strategy[v] = NO_VERTEX;
-            }
-            else
-            {
-                continue;  // not in the attractor set yet!
-            }
-
-            // Add vertex v to the attractor set:
-            if (vertices[v].compare_and_swap(1, 0) == 0) todo.push(v);
-        }
-    }
-}
-
 ConcurrentRecursiveSolver::ConcurrentRecursiveSolver(const ParityGame &game)
-    : ParityGameSolver(game)
+    : ParityGameSolver(game), attractor_(game.graph().V())
 {
-    assert(sizeof(tbb::atomic<char>) == 1);
 }
 
 ConcurrentRecursiveSolver::~ConcurrentRecursiveSolver()
@@ -114,20 +60,20 @@ bool ConcurrentRecursiveSolver::solve(ParityGame &game, Substrategy &strat)
         // Compute attractor set of minimum priority vertices:
         {
             ParityGame::Player player = (ParityGame::Player)((prio - 1)%2);
-            std::vector< tbb::atomic<char> > min_prio_attr(V);
-            tbb::concurrent_queue<verti> min_prio_attr_queue;
+            DenseSet<verti> min_prio_attr(0, V);
+            std::vector<verti> frontier;
             for (verti v = 0; v < V; ++v)
             {
                 if (game.priority(v) < prio)
                 {
-                    min_prio_attr[v] = 1;
-                    min_prio_attr_queue.push(v);
+                    min_prio_attr.insert(v);
+                    frontier.push_back(v);
                 }
             }
-            assert(!min_prio_attr_queue.empty());
-            concurrent_make_attractor_set( game, player, min_prio_attr,
-                                           min_prio_attr_queue, strat );
-            concurrent_get_complement(min_prio_attr).swap(unsolved);
+            assert(!frontier.empty());
+            attractor_.make_attractor_set( game, player, min_prio_attr,
+                                           frontier, strat );
+            get_complement(V, min_prio_attr).swap(unsolved);
             if (unsolved.empty()) break;
         }
 
@@ -140,21 +86,21 @@ bool ConcurrentRecursiveSolver::solve(ParityGame &game, Substrategy &strat)
 
             // Compute attractor set of all vertices won by the opponent:
             ParityGame::Player opponent = (ParityGame::Player)(prio%2);
-            std::vector<  tbb::atomic<char> > lost_attr(V);
-            tbb::concurrent_queue<verti> lost_attr_queue;
+            DenseSet<verti> lost_attr(0, V);
+            std::vector<verti> frontier;
             for ( std::vector<verti>::const_iterator it = unsolved.begin();
                   it != unsolved.end(); ++it )
             {
                 if (strat.winner(*it, game.player(*it)) == opponent)
                 {
-                    lost_attr[*it] = 1;
-                    lost_attr_queue.push(*it);
+                    lost_attr.insert(*it);
+                    frontier.push_back(*it);
                 }
             }
-            if (lost_attr_queue.empty()) break;
-            concurrent_make_attractor_set( game, opponent, lost_attr,
-                                           lost_attr_queue, strat );
-            concurrent_get_complement(lost_attr).swap(unsolved);
+            if (frontier.empty()) break;
+            attractor_.make_attractor_set( game, opponent, lost_attr,
+                                           frontier, strat );
+            get_complement(V, lost_attr).swap(unsolved);
         }
 
         // Repeat with subgame of which vertices won by odd have been removed:
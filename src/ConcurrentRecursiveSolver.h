@@ -11,6 +11,7 @@
 #define CONCURRENT_RECURSIVE_SOLVER_H_INCLUDED
 
 #include "RecursiveSolver.h"
+#include "attractor.h"
 
 //! Concurrent implementation of Zielonka's recursive algorithm.
 class ConcurrentRecursiveSolver : public ParityGameSolver, public virtual Logger
@@ -24,6 +25,9 @@ public:
 private:
     //! Solves a subgame recursively, or returns false if solving is aborted.
     bool solve(ParityGame &game, Substrategy &strat);
+
+    //! Workspace for attractor set computations, shared by all subgames.
+    ParallelAttractorContext attractor_;
 };
 
 //! Factory class for ConcurrentRecursiveSolver instances.
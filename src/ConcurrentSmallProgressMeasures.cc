@@ -0,0 +1,410 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "ConcurrentSmallProgressMeasures.h"
+#include "LinearLiftingStrategy.h"
+#include "PredecessorLiftingStrategy.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <assert.h>
+#include <sched.h>
+
+//
+//  ConcurrentSPM
+//
+
+ConcurrentSPM::ConcurrentSPM( const ParityGame &game, ParityGame::Player player,
+                              LiftingStatistics *stats,
+                              const verti *vertex_map, verti vertex_map_size,
+                              Order order )
+    : DenseSPM(game, player, stats, vertex_map, vertex_map_size),
+      order_(order), version_(new unsigned[game.graph().V()]()),
+      queued_(new char[game.graph().V()]()),
+      pool_size_(0), idle_(0), stop_(false)
+{
+    omp_init_lock(&pool_lock_);
+
+    // Initially, all vertices that are not top yet are queued:
+    const verti V = game.graph().V();
+    for (verti v = V; v > 0; --v)
+    {
+        if (!is_top(v - 1))
+        {
+            queued_[v - 1] = 1;
+            pool_.push_back(v - 1);
+        }
+    }
+    pool_size_ = pool_.size();
+}
+
+ConcurrentSPM::~ConcurrentSPM()
+{
+    omp_destroy_lock(&pool_lock_);
+    delete[] version_;
+    delete[] queued_;
+}
+
+void ConcurrentSPM::lock(verti v)
+{
+    for (;;)
+    {
+        unsigned version = __atomic_load_n(&version_[v], __ATOMIC_RELAXED);
+        if ( version%2 == 0 &&
+             __atomic_compare_exchange_n( &version_[v], &version, version + 1,
+                    false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) break;
+        sched_yield();
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void ConcurrentSPM::read_vec(verti v, verti *dst, int n)
+{
+    const verti *src = vec(v);
+    for (;;)
+    {
+        unsigned version = __atomic_load_n(&version_[v], __ATOMIC_ACQUIRE);
+        if (version%2 == 0)
+        {
+            std::copy(src, src + n, dst);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&version_[v], __ATOMIC_RELAXED) == version)
+            {
+                break;
+            }
+        }
+        sched_yield();
+    }
+}
+
+bool ConcurrentSPM::lift(verti v, verti *buf)
+{
+    const int N = len(v);
+    const bool max = take_max(v);
+    verti *ext = buf, *cur = buf + len_;
+
+    // Find extreme successor, using consistent copies of successor vectors:
+    const verti *it  = game_.graph().succ_begin(v),
+                *end = game_.graph().succ_end(v);
+    assert(it < end);
+    for (bool first = true; it != end; ++it, first = false)
+    {
+        // N.B. copy at least one element, so top is copied even if N == 0.
+        read_vec(*it, cur, std::max(N, 1));
+        if (first) std::swap(ext, cur);
+        else
+        {
+            int d = vector_cmp(cur, ext, N);
+            if (max ? d > 0 : d < 0) std::swap(ext, cur);
+        }
+    }
+
+    // Update vector for v, if the new value is greater:
+    bool carry = compare_strict(v);
+    lock(v);
+    verti *dst = &spm_[(size_t)len_*v];
+    bool changed = !is_top(dst) && vector_cmp(dst, ext, N) < carry;
+    if (changed)
+    {
+        // Like DenseSPM::set_vec(), but decreasing the vector space atomically:
+        int k = N;
+        for (int n = N - 1; n >= 0 && !is_top(ext); --n)
+        {
+            cur[n] = ext[n] + carry;
+            carry = (cur[n] >= __atomic_load_n(&M_[n], __ATOMIC_RELAXED));
+            if (carry) k = n;
+        }
+        if (is_top(ext) || carry)
+        {
+            set_vec_to_top(v);
+            int prio = game_.priority(v);
+            if (prio%2 != p_) __atomic_sub_fetch(&M_[prio/2], 1, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            while (k < N) cur[k++] = 0;
+            std::copy(cur, cur + N, dst);
+        }
+    }
+    unlock(v);
+    return changed;
+}
+
+bool ConcurrentSPM::take_work(std::deque<verti> &local, int num_threads)
+{
+    omp_set_lock(&pool_lock_);
+    __atomic_add_fetch(&idle_, 1, __ATOMIC_RELEASE);
+    while (pool_.empty() && idle() < num_threads && !stopped())
+    {
+        omp_unset_lock(&pool_lock_);
+        while (pool_size() == 0 && idle() < num_threads && !stopped())
+        {
+            sched_yield();
+        }
+        omp_set_lock(&pool_lock_);
+    }
+    bool success = !pool_.empty() && !stopped();
+    if (success)
+    {
+        __atomic_sub_fetch(&idle_, 1, __ATOMIC_RELEASE);
+        size_t count = (pool_.size() + num_threads - 1)/num_threads;
+        local.insert(local.end(), pool_.end() - count, pool_.end());
+        pool_.resize(pool_.size() - count);
+        __atomic_store_n(&pool_size_, pool_.size(), __ATOMIC_RELEASE);
+    }
+    omp_unset_lock(&pool_lock_);
+    return success;
+}
+
+void ConcurrentSPM::give_work(std::deque<verti> &local, size_t count)
+{
+    omp_set_lock(&pool_lock_);
+    pool_.insert(pool_.end(), local.end() - count, local.end());
+    __atomic_store_n(&pool_size_, pool_.size(), __ATOMIC_RELEASE);
+    omp_unset_lock(&pool_lock_);
+    local.resize(local.size() - count);
+}
+
+bool ConcurrentSPM::refill( std::deque<verti> &local, std::deque<verti> &next,
+                            bool &backward, int num_threads )
+{
+    assert(local.empty());
+    local.swap(next);
+    if (local.empty() && !take_work(local, num_threads)) return false;
+    if (order_ == LINEAR || order_ == ALTERNATE)
+    {
+        if (order_ == ALTERNATE) backward = !backward;
+        if (backward)
+        {
+            std::sort(local.begin(), local.end(), std::greater<verti>());
+        }
+        else
+        {
+            std::sort(local.begin(), local.end());
+        }
+    }
+    return true;
+}
+
+long long ConcurrentSPM::solve_concurrently(long long max_attempts)
+{
+    const StaticGraph &graph = game_.graph();
+    long long total_attempts = 0, total_lifts = 0;
+    int num_threads = 1;
+
+    __atomic_store_n(&idle_, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&stop_, false, __ATOMIC_RELEASE);
+
+    #pragma omp parallel reduction(+:total_attempts,total_lifts)
+    {
+        #pragma omp single
+        num_threads = omp_get_num_threads();
+
+        // Vertices queued during a linear pass are lifted in the next pass:
+        std::deque<verti> local, next;
+        std::deque<verti> &pushed =
+            (order_ == LINEAR || order_ == ALTERNATE) ? next : local;
+        std::vector<verti> buf(2*len_);
+        long long attempts = 0, lifts = 0;
+        bool backward = (order_ == ALTERNATE);
+
+        while ( !stopped() &&
+                (!local.empty() || refill(local, next, backward, num_threads)) )
+        {
+            if (attempts == max_attempts)
+            {
+                __atomic_store_n(&stop_, true, __ATOMIC_RELEASE);
+                break;
+            }
+
+            verti v;
+            if (order_ == STACK)
+            {
+                v = local.back();
+                local.pop_back();
+            }
+            else
+            {
+                v = local.front();
+                local.pop_front();
+            }
+            dequeue(v);
+
+            ++attempts;
+            if (lift(v, &buf[0]))
+            {
+                ++lifts;
+                for ( StaticGraph::const_iterator it = graph.pred_begin(v);
+                      it != graph.pred_end(v); ++it )
+                {
+                    // N.B. reading top status without locking is only a hint:
+                    if (!is_top(*it) && enqueue(*it)) pushed.push_back(*it);
+                }
+            }
+
+            // Share half of our work when other threads are waiting for it:
+            if (idle() > 0 && pool_size() == 0)
+            {
+                if (local.size() > 1)
+                {
+                    give_work(local, local.size()/2);
+                }
+                else
+                if (next.size() > 1)
+                {
+                    give_work(next, next.size()/2);
+                }
+            }
+        }
+
+        // Return remaining work to the pool for the next call:
+        if (!local.empty()) give_work(local, local.size());
+        if (!next.empty()) give_work(next, next.size());
+
+        total_attempts += attempts;
+        total_lifts    += lifts;
+    }
+
+    if (stats_ != NULL)
+    {
+        stats_->add_lifts_attempted(total_attempts);
+        stats_->add_lifts_succeeded(total_lifts);
+    }
+
+    bool solved = idle() == num_threads;
+    assert(!solved || pool_.empty());
+    if (!solved) return 0;
+    return std::max(1LL, max_attempts*num_threads - total_attempts);
+}
+
+
+//
+//  ConcurrentSmallProgressMeasuresSolver
+//
+
+ConcurrentSmallProgressMeasuresSolver::ConcurrentSmallProgressMeasuresSolver(
+    const ParityGame &game, LiftingStatistics *stats,
+    const verti *vmap, verti vmap_size, ConcurrentSPM::Order order )
+        : ParityGameSolver(game), stats_(stats),
+          vmap_(vmap), vmap_size_(vmap_size), order_(order)
+{
+}
+
+ConcurrentSmallProgressMeasuresSolver::~ConcurrentSmallProgressMeasuresSolver()
+{
+}
+
+bool ConcurrentSmallProgressMeasuresSolver::solve_all(ConcurrentSPM &spm)
+{
+    while (spm.solve_concurrently() == 0)
+    {
+        if (aborted()) return false;
+    }
+#ifdef DEBUG
+    debug("Verifying small progress measures.");
+    assert(spm.verify_solution());
+#endif
+    return true;
+}
+
+ParityGame::Strategy ConcurrentSmallProgressMeasuresSolver::solve()
+{
+    ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
+    std::vector<verti> won_by_odd;
+
+    {
+        info("Solving for Even concurrently...");
+        ConcurrentSPM spm( game(), ParityGame::PLAYER_EVEN,
+                           stats_, vmap_, vmap_size_, order_ );
+        if (!solve_all(spm)) return ParityGame::Strategy();
+        spm.get_strategy(strategy);
+        spm.get_winning_set( ParityGame::PLAYER_ODD,
+            std::back_insert_iterator<std::vector<verti> >(won_by_odd) );
+    }
+
+    if (!won_by_odd.empty())
+    {
+        // Make a dual subgame of the vertices won by player Odd
+        ParityGame subgame;
+        info("Constructing subgame of size %ld to solve for Odd...",
+             (long)won_by_odd.size());
+        subgame.make_subgame(game_, won_by_odd.begin(), won_by_odd.end(), true);
+        subgame.compress_priorities();
+
+        // Create vertex map to use:
+        std::vector<verti> submap_data;
+        verti *submap = &won_by_odd[0];
+        size_t submap_size = won_by_odd.size();
+        if (vmap_)
+        {
+            submap_data = won_by_odd;
+            submap = &submap_data[0];
+            merge_vertex_maps(submap, submap + submap_size, vmap_, vmap_size_);
+        }
+
+        // Second pass; solve subgame of vertices won by Odd:
+        info("Solving for Odd concurrently...");
+        ConcurrentSPM spm( subgame, ParityGame::PLAYER_ODD,
+                           stats_, submap, submap_size, order_ );
+        if (!solve_all(spm)) return ParityGame::Strategy();
+        ParityGame::Strategy substrat(won_by_odd.size(), NO_VERTEX);
+        spm.get_strategy(substrat);
+        merge_strategies(strategy, substrat, won_by_odd);
+    }
+
+    return strategy;
+}
+
+
+//
+//  ConcurrentSmallProgressMeasuresSolverFactory
+//
+
+ConcurrentSmallProgressMeasuresSolverFactory::
+    ConcurrentSmallProgressMeasuresSolverFactory(
+        LiftingStrategyFactory *lsf, LiftingStatistics *stats )
+    : stats_(stats), order_(ConcurrentSPM::QUEUE)
+{
+    bool supported = get_order(lsf, order_);
+    assert(supported);
+    (void)supported;
+}
+
+ParityGameSolver *ConcurrentSmallProgressMeasuresSolverFactory::create(
+    const ParityGame &game, const verti *vmap, verti vmap_size )
+{
+    return new ConcurrentSmallProgressMeasuresSolver(
+        game, stats_, vmap, vmap_size, order_ );
+}
+
+bool ConcurrentSmallProgressMeasuresSolverFactory::supports(
+    LiftingStrategyFactory *lsf )
+{
+    ConcurrentSPM::Order order;
+    return get_order(lsf, order);
+}
+
+bool ConcurrentSmallProgressMeasuresSolverFactory::get_order(
+    LiftingStrategyFactory *lsf, ConcurrentSPM::Order &order )
+{
+    if ( PredecessorLiftingStrategyFactory *plsf =
+            dynamic_cast<PredecessorLiftingStrategyFactory*>(lsf) )
+    {
+        order = plsf->stack() ? ConcurrentSPM::STACK : ConcurrentSPM::QUEUE;
+        return true;
+    }
+    if ( LinearLiftingStrategyFactory *llsf =
+            dynamic_cast<LinearLiftingStrategyFactory*>(lsf) )
+    {
+        order = llsf->alternate() ? ConcurrentSPM::ALTERNATE
+                                  : ConcurrentSPM::LINEAR;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,212 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef CONCURRENT_SMALL_PROGRESS_MEASURES_H_INCLUDED
+#define CONCURRENT_SMALL_PROGRESS_MEASURES_H_INCLUDED
+
+#include "SmallProgressMeasures.h"
+#include <omp.h>
+#include <deque>
+#include <vector>
+
+/*! \ingroup SmallProgressMeasures
+
+    A dense small progress measures implementation that allows vertices to be
+    lifted by multiple threads at once.
+
+    Each worker thread lifts vertices from a private work queue; when other
+    threads run out of work, part of it is handed over through a shared pool.
+
+    Progress measure vectors are updated optimistically: every vector has a
+    version number that is odd while the vector is being updated. Readers copy
+    a vector without locking and retry if its version changed in the meantime,
+    so a lifting attempt computes its new value from consistent snapshots of
+    the successor vectors. Since vectors only ever increase, lifting to a value
+    based on outdated snapshots is safe; the vertex is simply queued again when
+    a successor changes after it was dequeued.
+
+    The vector space `M` is decreased atomically when vertices are lifted to
+    top, and read atomically when lifting. Threads that read an outdated
+    (larger) bound compute a smaller vector, which is again safe.
+*/
+class ConcurrentSPM : public DenseSPM
+{
+public:
+    /*! Order in which each thread lifts the vertices in its work list:
+        first-in-first-out or last-in-first-out (like the predecessor lifting
+        strategy), or in passes over increasing vertex indices (like the
+        linear lifting strategy), optionally alternating direction. */
+    enum Order { QUEUE = 0, STACK = 1, LINEAR = 2, ALTERNATE = 3 };
+
+    ConcurrentSPM(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats = 0,
+        const verti *vertex_map = 0, verti vertex_map_size = 0,
+        Order order = QUEUE );
+    ~ConcurrentSPM();
+
+    /*! Lifts vertices concurrently, using all available OpenMP threads, until
+        no more vertices can be lifted or each thread has performed
+        `max_attempts` lifting attempts.
+
+        \return How many attempts remain; i.e. if the result is greater than
+                zero, the game is succesfully solved. */
+    long long solve_concurrently(long long max_attempts = work_size);
+
+private:
+    ConcurrentSPM(const ConcurrentSPM &);
+    ConcurrentSPM &operator=(const ConcurrentSPM &);
+
+    /*! Acquires exclusive access to the vector of vertex `v` by making its
+        version number odd. */
+    inline void lock(verti v);
+
+    //! Releases the vector of vertex `v`, making its version number even.
+    inline void unlock(verti v)
+    {
+        __atomic_store_n(&version_[v], version_[v] + 1, __ATOMIC_RELEASE);
+    }
+
+    /*! Copies the first `n` elements of the vector of vertex `v` to `dst`,
+        retrying until a consistent snapshot has been read. */
+    inline void read_vec(verti v, verti *dst, int n);
+
+    /*! Marks `v` as queued and returns true, or returns false if it was
+        queued already. */
+    inline bool enqueue(verti v)
+    {
+        char expected = 0;
+        return __atomic_compare_exchange_n( &queued_[v], &expected, 1, false,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED );
+    }
+
+    /*! Clears the queued mark for `v`. This is a full memory barrier, so
+        vectors read afterwards are at least as recent as the vectors that
+        caused `v` to be queued. */
+    inline void dequeue(verti v)
+    {
+        __atomic_exchange_n(&queued_[v], 0, __ATOMIC_SEQ_CST);
+    }
+
+    /*! Attempts to lift vertex `v` to its extreme successor and returns
+        whether its vector changed. `buf` must have room for 2*len_ elements. */
+    bool lift(verti v, verti *buf);
+
+    /*! Moves work from the shared pool to `local`, waiting for other threads
+        to donate work if the pool is empty. Returns false when all threads
+        have run out of work, or when lifting is being stopped. */
+    bool take_work(std::deque<verti> &local, int num_threads);
+
+    //! Moves the last `count` entries of `local` to the shared pool.
+    void give_work(std::deque<verti> &local, size_t count);
+
+    /*! Refills the empty work list `local` from the vertices queued for the
+        next pass in `next`, or from the shared pool, and sorts it if lifting
+        in linear order. Returns false if no more work is available.
+        `backward` holds the direction of the current linear pass. */
+    bool refill( std::deque<verti> &local, std::deque<verti> &next,
+                 bool &backward, int num_threads );
+
+    //! Returns the number of threads without work.
+    int idle() const { return __atomic_load_n(&idle_, __ATOMIC_ACQUIRE); }
+
+    //! Returns whether all threads have been signaled to stop.
+    bool stopped() const { return __atomic_load_n(&stop_, __ATOMIC_ACQUIRE); }
+
+    //! Returns the size of the shared pool, which may be outdated.
+    size_t pool_size() const
+    {
+        return __atomic_load_n(&pool_size_, __ATOMIC_ACQUIRE);
+    }
+
+private:
+    const Order         order_;         //!< order of per-thread work lists
+    unsigned            *version_;      //!< per-vertex vector versions
+    char                *queued_;       //!< marks vertices in some work list
+    std::vector<verti>  pool_;          //!< shared pool of queued vertices
+    size_t              pool_size_;     //!< size of pool_ (read unlocked)
+    omp_lock_t          pool_lock_;     //!< protects pool_ and idle_ updates
+    int                 idle_;          //!< number of threads without work
+    bool                stop_;          //!< signals all threads to stop
+};
+
+/*! \ingroup SmallProgressMeasures
+
+    A parity game solver that implements the small progress measures
+    algorithm using multiple threads to lift vertices concurrently.
+
+    Vertices are lifted from per-thread work lists, so only lifting strategies
+    that can be expressed as a work list order are supported: the predecessor
+    strategy (as a queue or stack) and the linear strategy (as passes over the
+    queued vertices in index order). Friedmann's two-sided approach is not
+    supported. */
+class ConcurrentSmallProgressMeasuresSolver
+    : public ParityGameSolver, public virtual Logger
+{
+public:
+    ConcurrentSmallProgressMeasuresSolver( const ParityGame &game,
+                                           LiftingStatistics *stats = 0,
+                                           const verti *vertex_map = 0,
+                                           verti vertex_map_size = 0,
+                                           ConcurrentSPM::Order order
+                                               = ConcurrentSPM::QUEUE );
+    ~ConcurrentSmallProgressMeasuresSolver();
+
+    ParityGame::Strategy solve();
+
+private:
+    /*! Lifts all vertices in `spm` until it is stable, or returns false if
+        solving is aborted. */
+    bool solve_all(ConcurrentSPM &spm);
+
+private:
+    ConcurrentSmallProgressMeasuresSolver(
+        const ConcurrentSmallProgressMeasuresSolver&);
+    ConcurrentSmallProgressMeasuresSolver &operator=(
+        const ConcurrentSmallProgressMeasuresSolver&);
+
+protected:
+    LiftingStatistics *stats_;      //!< object to record lifting statistics
+    const verti *vmap_;             //!< current vertex map
+    const verti vmap_size_;         //!< size of vertex map
+    const ConcurrentSPM::Order order_;  //!< order of per-thread work lists
+};
+
+/*! \ingroup SmallProgressMeasures
+
+    Factory class for ConcurrentSmallProgressMeasuresSolver instances.
+    The work list order of created solvers is derived from the given lifting
+    strategy factory, which must be supported (see supports()). */
+class ConcurrentSmallProgressMeasuresSolverFactory
+    : public ParityGameSolverFactory
+{
+public:
+    ConcurrentSmallProgressMeasuresSolverFactory(
+        LiftingStrategyFactory *lsf, LiftingStatistics *stats = 0 );
+
+    ParityGameSolver *create( const ParityGame &game,
+                              const verti *vertex_map,
+                              verti vertex_map_size );
+
+    /*! Returns whether the strategy created by `lsf` can be used to order the
+        work lists of concurrent solvers. */
+    static bool supports(LiftingStrategyFactory *lsf);
+
+private:
+    /*! Stores the work list order equivalent to `lsf` in `order` and returns
+        true, or returns false if there is no such order. */
+    static bool get_order( LiftingStrategyFactory *lsf,
+                           ConcurrentSPM::Order &order );
+
+private:
+    LiftingStatistics       *stats_;
+    ConcurrentSPM::Order    order_;
+};
+
+#endif /* ndef CONCURRENT_SMALL_PROGRESS_MEASURES_H_INCLUDED */
@@ -9,6 +9,7 @@
 
 #include "DecycleSolver.h"
 #include "attractor.h"
+#include <iterator>
 #include <memory>
 #include <assert.h>
 
@@ -22,9 +23,10 @@ struct CycleFinder
                  const std::vector<verti> &mapping );
 
     /*! Search for minimum-priority cycles and vertices in their attractor sets,
-        and update `strategy`, `done_set` and `done_queue` accordingly.
+        and update `strategy`, `done_set` and `done_queue` accordingly, using
+        `attractor` as workspace for attractor set computations.
         Takes O(E) time. */
-    void run( ParityGame::Strategy &strategy,
+    void run( ParityGame::Strategy &strategy, AttractorContext &attractor,
               DenseSet<verti> &done_set, std::deque<verti> &done_queue );
 
     // SCC callback
@@ -48,6 +50,7 @@ CycleFinder::CycleFinder( const ParityGame &game,
 }
 
 void CycleFinder::run( ParityGame::Strategy &strategy,
+    AttractorContext &attractor,
     DenseSet<verti> &done_set, std::deque<verti> &done_queue )
 {
     // Identify key vertices which are part of the winning set:
@@ -57,8 +60,9 @@ void CycleFinder::run( ParityGame::Strategy &strategy,
     {
         // Extend to attractor in subgame. This guarantees the strategy indeed
         // leads to cycles of priority prio_:
-        make_attractor_set( subgame_, (ParityGame::Player)(prio_%2),
-                            winning_set_, winning_queue_, substrat_ );
+        attractor.make_attractor_set( subgame_, subgame_.graph(),
+            (ParityGame::Player)(prio_%2), winning_set_, winning_queue_,
+            substrat_ );
 
         // Map computed winning set and strategy back to global game:
         for ( DenseSet<verti>::const_iterator it = winning_set_.begin();
@@ -125,6 +129,7 @@ ParityGame::Strategy DecycleSolver::solve()
     const verti V = game_.graph().V();
     ParityGame::Strategy strategy(V, NO_VERTEX);
     DenseSet<verti> solved_set(0, V);
+    AttractorContext attractor(V);
 
     // Find owner-controlled cycles for every priority value:
     for (int prio = 0; prio < game_.d(); ++prio)
@@ -147,17 +152,17 @@ ParityGame::Strategy DecycleSolver::solve()
         // Find (attractor set of) winning cycles in subgame:
         std::deque<verti> solved_queue;
         CycleFinder cf(game_, prio, mapping);
-        cf.run(strategy, solved_set, solved_queue);
+        cf.run(strategy, attractor, solved_set, solved_queue);
 
         // Extend to attractor set in the global game:
-        make_attractor_set( game_, (ParityGame::Player)(prio%2),
-                            solved_set, solved_queue, strategy );
+        attractor.make_attractor_set( game_, game_.graph(),
+            (ParityGame::Player)(prio%2), solved_set, solved_queue, strategy );
 
         verti new_size = solved_set.size();
         if (old_size < new_size)
         {
-            info( "(DecycleSolver) Identified %d vertices in %d-dominated "
-                  "cycles.", new_size - old_size, prio );
+            info( "(DecycleSolver) Identified %ld vertices in %d-dominated "
+                  "cycles.", (long)(new_size - old_size), prio );
         }
 
         // Early out: if all vertices are solved, it is pointless to continue.
@@ -175,16 +180,13 @@ ParityGame::Strategy DecycleSolver::solve()
     }
 
     const verti num_unsolved = V - (verti)solved_set.size();
-    info( "(DecycleSolver) Creating subgame with %d vertices remaining...",
-            num_unsolved );
+    info( "(DecycleSolver) Creating subgame with %ld vertices remaining...",
+            (long)num_unsolved );
 
     // Gather remaining unsolved vertices:
     std::vector<verti> unsolved;
     unsolved.reserve(num_unsolved);
-    for (verti v = 0; v < V; ++v)
-    {
-        if (!solved_set.count(v)) unsolved.push_back(v);
-    }
+    solved_set.copy_complement(std::back_inserter(unsolved));
     assert(!unsolved.empty() && unsolved.size() == num_unsolved);
 
     // Construct subgame for the unsolved part:
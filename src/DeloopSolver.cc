@@ -9,6 +9,7 @@
 
 #include "DeloopSolver.h"
 #include "attractor.h"
+#include <iterator>
 #include <memory>
 #include <assert.h>
 
@@ -32,6 +33,7 @@ ParityGame::Strategy DeloopSolver::solve()
 
     info("(DeloopSolver) Searching for winning loops...");
     DenseSet<verti> solved(0, V);
+    AttractorContext attractor(V);
     for (int player = 0; player < 2; ++player)
     {
         verti old_solved = (verti)solved.size();
@@ -52,12 +54,12 @@ ParityGame::Strategy DeloopSolver::solve()
         // Compute attractor set and associated strategy:
         for ( std::deque<verti>::const_iterator it = winning.begin();
                 it != winning.end(); ++it ) solved.insert(*it);
-        make_attractor_set( game_, (ParityGame::Player)player,
-                            solved, winning, strategy );
+        attractor.make_attractor_set( game_, game_.graph(),
+            (ParityGame::Player)player, solved, winning, strategy );
 
         verti num_solved = (verti)solved.size() - old_solved;
-        info( "(DeloopSolver) Found %d vertices won by %s",
-              num_solved, player == 0 ? "Even" : "Odd" );
+        info( "(DeloopSolver) Found %ld vertices won by %s",
+              (long)num_solved, player == 0 ? "Even" : "Odd" );
     }
 
     std::vector<verti> unsolved;
@@ -77,15 +79,12 @@ ParityGame::Strategy DeloopSolver::solve()
     if (solved.size() != V)
     {
         const verti num_unsolved = V - (verti)solved.size();
-        info( "(DeloopSolver) Creating subgame with %d vertices remaining...",
-                num_unsolved );
+        info( "(DeloopSolver) Creating subgame with %ld vertices remaining...",
+                (long)num_unsolved );
 
         // Create game with remaining unsolved vertices:
         unsolved.reserve(num_unsolved);
-        for (verti v = 0; v < V; ++v)
-        {
-            if (solved.count(v) == 0) unsolved.push_back(v);
-        }
+        solved.copy_complement(std::back_inserter(unsolved));
         assert(!unsolved.empty() && unsolved.size() == num_unsolved);
 
         subgame.make_subgame(game_, unsolved.begin(), unsolved.end(), true);
@@ -10,6 +10,7 @@
 #ifndef DENSE_SET_H_INCLUDED
 #define DENSE_SET_H_INCLUDED
 
+#include "compatibility.h"
 #include <cstdlib>
 #include <memory>
 #include <utility>
@@ -28,18 +29,23 @@
     iterate over the set is proportional to the size of the range (*not* the 
     size of the set, i.e. the number of elements).
 
-    Internally, the DenseSet uses an array of bools to note the presence/absence
-    of elements, which typically requires one byte per value in range.
+    Internally, the DenseSet uses a bitset to note the presence/absence of
+    elements, which requires one bit per value in range. Iteration and bulk
+    operations process 64 values at a time, so iterating over a sparse set
+    takes (range size)/64 word operations, plus one per element.
 
     \see DenseMap
 */
 
 // N.B. this class is far from finished!
 
-template< class Key, class Alloc = std::allocator<bool> >
+template< class Key, class Alloc = std::allocator<compat_uint64_t> >
 class DenseSet
 {
 public:
+    typedef compat_uint64_t word_t;
+    static const size_t word_bits = 64;
+
     class Iterator
     {
         const DenseSet *set_;
@@ -73,11 +79,11 @@ public:
 
         Iterator& operator++()
         {
-            do ++key_; while (!set_->used_[key_]);
+            key_ = set_->next(key_ + 1);
             return *this;
         }
 
-        Iterator& operator++(int)
+        Iterator operator++(int)
         {
             Iterator copy = *this;
             ++*this;
@@ -92,16 +98,17 @@ public:
 
     DenseSet(Key begin, Key end, const Alloc &alloc = Alloc())
         : range_begin(begin), range_end(end < begin ? begin : end),
-          range_size_(range_end - range_begin), alloc_(alloc),
-          used_(alloc_.allocate(range_size_ + 1)), num_used_(0)
+          range_size_(range_end - range_begin),
+          num_words_(range_size_/word_bits + 1), alloc_(alloc),
+          words_(alloc_.allocate(num_words_)), num_used_(0)
     {
-        for (size_type i = 0; i < range_size_; ++i) used_[i] = false;
-        used_[range_size_] = true;  // marks end of data
+        for (size_type i = 0; i < num_words_; ++i) words_[i] = 0;
+        set_sentinel();
     }
 
     ~DenseSet()
     {
-        alloc_.deallocate(used_, range_size_ + 1);
+        alloc_.deallocate(words_, num_words_);
     }
 
     size_type size() const
@@ -118,21 +125,20 @@ public:
     {
         if (num_used_ > 0)
         {
-            for (size_type i = 0; i < range_size_; ++i) used_[i] = false;
+            for (size_type i = 0; i < num_words_; ++i) words_[i] = 0;
+            set_sentinel();
             num_used_ = 0;
         }
     }
 
     iterator begin()
     {
-        Key k = range_begin;
-        while (!used_[k - range_begin]) ++k;
-        return iterator(this, k);
+        return iterator(this, next(range_begin));
     }
 
     iterator end()
     {
-        return iterator(this, range_size_);
+        return iterator(this, range_end);
     }
 
     const_iterator begin() const
@@ -147,7 +153,7 @@ public:
 
     iterator find(const Key &k)
     {
-        if ( /* k >= range_begin && k < range_end && */ used_[k - range_begin] )
+        if ( /* k >= range_begin && k < range_end && */ count(k) )
         {
             return iterator(this, k);
         }
@@ -164,19 +170,22 @@ public:
 
     size_type count(const Key &k) const
     {
-        return used_[k - range_begin];
+        size_type i = k - range_begin;
+        return (words_[i/word_bits] >> (i%word_bits)) & 1;
     }
 
     std::pair<iterator, bool> insert(const Key &k)
     {
-        bool &u = used_[k - range_begin];
-        if (u)
+        size_type i = k - range_begin;
+        word_t &w = words_[i/word_bits];
+        word_t bit = (word_t)1 << (i%word_bits);
+        if (w & bit)
         {
             return std::pair<iterator, bool>(iterator(this, k), false);
         }
         else
         {
-            u = true;
+            w |= bit;
             ++num_used_;
             return std::pair<iterator, bool>(iterator(this, k), true);
         }
@@ -185,11 +194,113 @@ public:
     template <class InputIterator>
     void insert(InputIterator it, InputIterator end)
     {
-        for ( ; it != end; ++it)
+        for ( ; it != end; ++it) insert(*it);
+    }
+
+    size_type erase(const Key &k)
+    {
+        size_type i = k - range_begin;
+        word_t &w = words_[i/word_bits];
+        word_t bit = (word_t)1 << (i%word_bits);
+        if (!(w & bit)) return 0;
+        w &= ~bit;
+        --num_used_;
+        return 1;
+    }
+
+    //! Returns an iterator to the least element not less than `k`.
+    iterator lower_bound(const Key &k)
+    {
+        return iterator(this, next(k));
+    }
+
+    /*! Returns the greatest element in the set that is less than `k`, or
+        range_end if there is none. */
+    Key prev(const Key &k) const
+    {
+        if (k == range_begin) return range_end;
+        size_type i = k - range_begin - 1, n = i/word_bits;
+        word_t w = words_[n] & (~(word_t)0 >> (word_bits - 1 - i%word_bits));
+        while (!w)
+        {
+            if (n == 0) return range_end;
+            w = words_[--n];
+        }
+        return range_begin + (Key)((n + 1)*word_bits - 1 - compat_clz64(w));
+    }
+
+    //!\name Bulk operations
+    //!@{
+
+    /*! Adds all elements of `s`, which must have the same range, to this set.
+        Takes O(N/64) time, where N is the size of the range. */
+    void insert_all(const DenseSet &s)
+    {
+        for (size_type i = 0; i < num_words_; ++i) words_[i] |= s.words_[i];
+        recount();
+    }
+
+    /*! Replaces the set with its complement with respect to its range.
+        Takes O(N/64) time, where N is the size of the range. */
+    void complement()
+    {
+        for (size_type i = 0; i < num_words_; ++i) words_[i] = ~words_[i];
+        set_sentinel();
+        num_used_ = range_size_ - num_used_;
+    }
+
+    /*! Writes the values in range that are not in the set to `out`, in
+        increasing order, and returns the end of the output. */
+    template<class OutputIterator>
+    OutputIterator copy_complement(OutputIterator out) const
+    {
+        for (size_type i = 0; i < num_words_; ++i)
+        {
+            word_t w = ~words_[i];
+            if (i == num_words_ - 1) w &= sentinel_bit() - 1;
+            for ( ; w; w &= w - 1)
+            {
+                *out++ = range_begin + (Key)(i*word_bits + compat_ctz64(w));
+            }
+        }
+        return out;
+    }
+
+    //!@}
+
+private:
+    /*! Returns the least element in the set that is greater than or equal
+        to `k`, or range_end if there is none. */
+    Key next(Key k) const
+    {
+        size_type i = k - range_begin, n = i/word_bits;
+        word_t w = words_[n] & (~(word_t)0 << (i%word_bits));
+        while (!w) w = words_[++n];  // terminates at sentinel bit
+        return range_begin + (Key)(n*word_bits + compat_ctz64(w));
+    }
+
+    //! Returns the bit that marks the end of the range in the last word.
+    word_t sentinel_bit() const
+    {
+        return (word_t)1 << (range_size_%word_bits);
+    }
+
+    //! Sets the sentinel bit and clears the padding bits beyond it.
+    void set_sentinel()
+    {
+        word_t &last = words_[num_words_ - 1];
+        last = (last & (sentinel_bit() - 1)) | sentinel_bit();
+    }
+
+    //! Recomputes the number of elements in the set.
+    void recount()
+    {
+        num_used_ = 0;
+        for (size_type i = 0; i < num_words_; ++i)
         {
-            Key k = *it;
-            used_[k - range_begin] = true;
+            num_used_ += compat_popcount64(words_[i]);
         }
+        --num_used_;  // don't count sentinel
     }
 
 public:
@@ -197,8 +308,9 @@ public:
 
 private:
     const size_type range_size_;
+    const size_type num_words_;
     Alloc           alloc_;
-    bool            *used_;
+    word_t          *words_;
     size_t          num_used_;
 
     friend class Iterator;
@@ -0,0 +1,120 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FIXED_DENSE_SPM_H_INCLUDED
+#define FIXED_DENSE_SPM_H_INCLUDED
+
+#include "SmallProgressMeasures.h"
+
+/*! \ingroup SmallProgressMeasures
+
+    A dense progress measures implementation for games with progress measure
+    vectors of at most `MaxLen` components (which is typical after priority
+    compression), stored as integers of type `T`.
+
+    Vector operations use loops of constant length that the compiler unrolls,
+    except that vectors are compared with vector_cmp_fixed(), and solve_some()
+    runs a lifting loop which calls these operations directly instead of
+    through virtual methods. The loop is instantiated separately for the most
+    common lifting strategies, so calls into the lifting strategy can be
+    resolved statically too; other strategies use the generic implementation
+    in SmallProgressMeasures.
+
+    Components may be stored in a type narrower than `verti` if it can hold
+    all values up to the vector space bounds M() (see fits()), which reduces
+    memory use and improves cache efficiency. The maximum value of `T` then
+    represents top. Since vec() must return an array of `verti`, vectors are
+    converted into one of `vec_buffers` internal buffers which are reused in
+    turn, so a pointer returned by vec() remains valid only until vec() has
+    been called `vec_buffers` more times. (This does not apply when `T` is
+    `verti`, in which case vectors are returned directly.)
+
+    \see SmallProgressMeasuresSolver::create_spm()
+*/
+template<int MaxLen, class T = verti>
+class FixedDenseSPM : public SmallProgressMeasures
+{
+public:
+    /*! Number of buffers used to return converted vectors from vec(), which
+        must be at least the number of vectors get_ext_succ() compares at
+        once. */
+    static const int vec_buffers = ext_batch_size;
+
+    /*! Number of components allocated after the last vector, so that the
+        vectors can be passed to vector_cmp_fixed(). */
+    static const int padding =
+        (vector_fixed_padding + sizeof(T) - 1)/sizeof(T);
+
+    FixedDenseSPM(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats = 0,
+        const verti *vertex_map = 0, verti vertex_map_size = 0 );
+    ~FixedDenseSPM();
+
+    /*! Returns whether components of type `T` can store progress measure
+        vectors with bounds up to `max_M` (inclusive, since set_vec() may
+        temporarily store the bound before carrying over). */
+    static bool fits(verti max_M) { return max_M < (verti)(T)-1; }
+
+    long long solve_some( LiftingStrategy &ls,
+                          long long max_attempts = work_size );
+    long long solve_some( LiftingStrategy2 &ls,
+                          long long max_attempts = work_size );
+
+    const verti *vec(verti v) const;
+    void set_vec(verti v, const verti src[], bool carry);
+    void set_vec_to_top(verti v);
+
+protected:
+    int vector_cmp(verti v, verti w, int N) const
+    {
+        return fixed_cmp(fvec(v), fvec(w), N);
+    }
+
+private:
+    /*! Lifting loop for version 1 lifting strategies of class `LS`. */
+    template<class LS>
+    long long solve_some_1(LS &ls, long long attempts);
+
+    /*! Lifting loop for version 2 lifting strategies of class `LS`. */
+    template<class LS>
+    long long solve_some_2(LS &ls, long long attempts);
+
+    //! Returns the stored SPM vector for vertex `v`.
+    const T *fvec(verti v) const { return &spm_[(size_t)len_*v]; }
+
+    //! Returns whether the given stored vector has top value.
+    static bool fis_top(const T vec[]) { return vec[0] == (T)-1; }
+
+    //! Equivalent of vector_cmp() for stored vectors.
+    inline int fixed_cmp(const T vec1[], const T vec2[], int N) const;
+
+    //! Equivalent of get_ext_succ() using fixed_cmp().
+    inline verti fixed_ext_succ(verti v, bool take_max) const;
+
+    //! Equivalent of lift_to() using fixed_cmp() and fixed_set_vec().
+    inline bool fixed_lift_to(verti v, const T vec2[], bool carry);
+
+    //! Equivalent of set_vec() for stored or `verti` source vectors.
+    template<class U>
+    inline void fixed_set_vec(verti v, const U src[], bool carry);
+
+private:
+    FixedDenseSPM(const FixedDenseSPM &);
+    FixedDenseSPM &operator=(const FixedDenseSPM &);
+
+private:
+    T *spm_;                                        //!< SPM vector data
+    mutable verti vec_buf_[vec_buffers][MaxLen];    //!< buffers for vec()
+    mutable int vec_buf_next_;                      //!< next buffer to use
+};
+
+#include "FixedDenseSPM_impl.h"
+
+#endif /* ndef FIXED_DENSE_SPM_H_INCLUDED */
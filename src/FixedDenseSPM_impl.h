@@ -0,0 +1,275 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// Don't include this file directly! Include FixedDenseSPM.h instead.
+
+#include "FocusListLiftingStrategy.h"
+#include "LinearLiftingStrategy.h"
+#include "MaxMeasureLiftingStrategy.h"
+#include "PredecessorLiftingStrategy.h"
+#include <algorithm>
+
+template<int MaxLen, class T>
+FixedDenseSPM<MaxLen, T>::FixedDenseSPM(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats,
+        const verti *vertex_map, verti vertex_map_size )
+    : SmallProgressMeasures(game, player, stats, vertex_map, vertex_map_size),
+      spm_(new T[(size_t)len_*game.graph().V() + padding]()),
+      vec_buf_next_(0)
+{
+    assert(len_ <= MaxLen);
+    assert(fits(*std::max_element(M_, M_ + len_)));
+    info("Storing progress measure vectors with %d-bit components.",
+         (int)(8*sizeof(T)));
+    initialize_loops();
+}
+
+template<int MaxLen, class T>
+FixedDenseSPM<MaxLen, T>::~FixedDenseSPM()
+{
+    delete[] spm_;
+}
+
+template<int MaxLen, class T>
+const verti *FixedDenseSPM<MaxLen, T>::vec(verti v) const
+{
+    if (sizeof(T) == sizeof(verti))
+    {
+        return reinterpret_cast<const verti*>(fvec(v));
+    }
+
+    verti *dst = vec_buf_[vec_buf_next_];
+    vec_buf_next_ = (vec_buf_next_ + 1)%vec_buffers;
+
+    const T *src = fvec(v);
+    if (fis_top(src))
+    {
+        dst[0] = NO_VERTEX;
+    }
+    else
+    {
+        for (int n = 0; n < MaxLen && n < len_; ++n) dst[n] = src[n];
+    }
+    return dst;
+}
+
+template<int MaxLen, class T>
+long long FixedDenseSPM<MaxLen, T>::solve_some( LiftingStrategy &ls,
+                                                long long attempts )
+{
+    // Note: lifting strategies are called with qualified names below, so
+    // these casts must match the exact class of the strategy object.
+    if (LinearLiftingStrategy *lls = dynamic_cast<LinearLiftingStrategy*>(&ls))
+    {
+        return solve_some_1(*lls, attempts);
+    }
+    if ( PredecessorLiftingStrategy *pls =
+            dynamic_cast<PredecessorLiftingStrategy*>(&ls) )
+    {
+        return solve_some_1(*pls, attempts);
+    }
+    return SmallProgressMeasures::solve_some(ls, attempts);
+}
+
+template<int MaxLen, class T>
+long long FixedDenseSPM<MaxLen, T>::solve_some( LiftingStrategy2 &ls,
+                                                long long attempts )
+{
+    if ( MaxMeasureLiftingStrategy2 *mls =
+            dynamic_cast<MaxMeasureLiftingStrategy2*>(&ls) )
+    {
+        return solve_some_2(*mls, attempts);
+    }
+    if ( BucketMaxMeasureLiftingStrategy2 *bls =
+            dynamic_cast<BucketMaxMeasureLiftingStrategy2*>(&ls) )
+    {
+        return solve_some_2(*bls, attempts);
+    }
+    if ( PredecessorLiftingStrategy *pls =
+            dynamic_cast<PredecessorLiftingStrategy*>(&ls) )
+    {
+        return solve_some_2(*pls, attempts);
+    }
+    if ( LinearLiftingStrategy2 *lls =
+            dynamic_cast<LinearLiftingStrategy2*>(&ls) )
+    {
+        return solve_some_2(*lls, attempts);
+    }
+    if ( FocusListLiftingStrategy2 *fls =
+            dynamic_cast<FocusListLiftingStrategy2*>(&ls) )
+    {
+        return solve_some_2(*fls, attempts);
+    }
+    return SmallProgressMeasures::solve_some(ls, attempts);
+}
+
+template<int MaxLen, class T> template<class LS>
+long long FixedDenseSPM<MaxLen, T>::solve_some_1(LS &ls, long long attempts)
+{
+    for ( ; attempts > 0; --attempts)
+    {
+        verti v = ls.LS::next();
+        if (v == NO_VERTEX) break;
+
+        bool success = false;
+        if (!fis_top(fvec(v)))
+        {
+            verti w = fixed_ext_succ(v, take_max(v));
+            if (fixed_lift_to(v, fvec(w), compare_strict(v)))
+            {
+                ls.LS::lifted(v);
+                if (!top_queue_.empty()) attract_top_1(ls);
+                success = true;
+            }
+        }
+        record_lift(v, success);
+    }
+    return attempts;
+}
+
+template<int MaxLen, class T> template<class LS>
+long long FixedDenseSPM<MaxLen, T>::solve_some_2(LS &ls, long long attempts)
+{
+    // See SmallProgressMeasures::solve_one(LiftingStrategy2 &) for comments.
+    const StaticGraph &graph = game_.graph();
+    for ( ; attempts > 0; --attempts)
+    {
+        verti v = ls.LS::pop();
+        while (v != NO_VERTEX && fis_top(fvec(v))) v = ls.LS::pop();
+        if (v == NO_VERTEX) break;
+
+        assert(!fis_top(fvec(v)));
+
+        bool success = fixed_lift_to( v, fvec(get_successor(v)),
+                                      compare_strict(v) );
+        assert(success);
+        (void)success;
+        dirty_[v] = false;
+        if (!top_queue_.empty()) attract_top_2(ls);
+
+        for ( const verti *it  = graph.pred_begin(v),
+                          *end = graph.pred_end(v); it != end; ++it )
+        {
+            verti u = *it;
+            if (fis_top(fvec(u))) continue;
+
+            bool changed;
+            if (!take_max(u))
+            {
+                changed = get_successor(u) == v;
+                if (changed) strategy_[u] = fixed_ext_succ(u, false);
+            }
+            else
+            {
+                changed = get_successor(u) == v;
+                if ( !changed &&
+                     fixed_cmp(fvec(v), fvec(get_successor(u)), len_) > 0 )
+                {
+                    strategy_[u] = v;
+                    changed = true;
+                }
+            }
+            if (changed)
+            {
+                if (is_dirty(u))
+                {
+                    ls.LS::bump(u);
+                }
+                else
+                {
+                    bool dirty = fixed_cmp( fvec(u), fvec(get_successor(u)),
+                                            len(u) ) < compare_strict(u);
+                    if (dirty)
+                    {
+                        dirty_[u] = true;
+                        ls.LS::push(u);
+                    }
+                }
+            }
+        }
+        record_lift(v, true);
+    }
+    return attempts;
+}
+
+template<int MaxLen, class T>
+int FixedDenseSPM<MaxLen, T>::fixed_cmp( const T vec1[], const T vec2[],
+                                         int N ) const
+{
+    return vector_cmp_fixed<MaxLen>(vec1, vec2, N);
+}
+
+template<int MaxLen, class T>
+verti FixedDenseSPM<MaxLen, T>::fixed_ext_succ(verti v, bool take_max) const
+{
+    const StaticGraph &graph = game_.graph();
+    const verti *it = graph.succ_begin(v), *end = graph.succ_end(v);
+    assert(it != end);
+
+    const int N = len(v);
+    verti res = *it++;
+    for ( ; it != end; ++it)
+    {
+        int d = fixed_cmp(fvec(*it), fvec(res), N);
+        if (take_max ? d > 0 : d < 0) res = *it;
+    }
+    return res;
+}
+
+template<int MaxLen, class T>
+bool FixedDenseSPM<MaxLen, T>::fixed_lift_to( verti v, const T vec2[],
+                                              bool carry )
+{
+    if (fis_top(fvec(v))) return false;
+
+    if (fis_top(vec2))
+    {
+        set_top(v);
+    }
+    else
+    {
+        if (fixed_cmp(fvec(v), vec2, len(v)) >= carry) return false;
+        fixed_set_vec(v, vec2, carry);
+    }
+    return true;
+}
+
+template<int MaxLen, class T>
+void FixedDenseSPM<MaxLen, T>::set_vec(verti v, const verti src[], bool carry)
+{
+    fixed_set_vec(v, src, carry);
+}
+
+template<int MaxLen, class T>
+void FixedDenseSPM<MaxLen, T>::set_vec_to_top(verti v)
+{
+    spm_[(size_t)len_*v] = (T)-1;
+}
+
+template<int MaxLen, class T> template<class U>
+void FixedDenseSPM<MaxLen, T>::fixed_set_vec( verti v, const U src[],
+                                              bool carry )
+{
+    T *dst = &spm_[(size_t)len_*v];
+    const int l = len(v);                   // l: vector length
+    int k = l;                              // k: position of last overflow
+    for (int n = MaxLen - 1; n >= 0; --n)
+    {
+        if (n >= l) continue;
+        dst[n] = (T)(src[n] + carry);
+        carry = (dst[n] >= M_[n]);
+        if (carry) k = n;
+    }
+    for (int n = 0; n < MaxLen; ++n)
+    {
+        if (n >= k && n < l) dst[n] = 0;
+    }
+    if (carry) set_top(v);
+}
@@ -37,6 +37,8 @@ void FocusListLiftingStrategy::lifted(verti vertex)
     }
     else /* phase_ == 2 */
     {
+        // The linear strategy must rescan all vertices after phase 2 too:
+        lls_.lifted(vertex);
         if (vertex == read_pos_->first) prev_lifted_ = true;
     }
 }
@@ -51,13 +53,13 @@ verti FocusListLiftingStrategy::next()
 verti FocusListLiftingStrategy::phase1()
 {
     if (focus_list_.size() == focus_list_.capacity() ||
-        num_lift_attempts_ >= V_)
+        num_lift_attempts_ >= (long long)V_)
     {
         if (focus_list_.empty())
         {
-            /* This can only happen if lls_.num_failed >= V too */
-            assert(lls_.next() == NO_VERTEX);
-            return NO_VERTEX;
+            /* Nothing was lifted in this phase; continue lifting linearly
+               until the linear strategy finds all vertices to be stable. */
+            return lls_.next();
         }
 
         /* Switch to phase 2: */
@@ -122,18 +124,119 @@ verti FocusListLiftingStrategy::phase2()
     return read_pos_->first;
 }
 
-LiftingStrategy *FocusListLiftingStrategyFactory::create(
-    const ParityGame &game, const SmallProgressMeasures &spm )
+FocusListLiftingStrategy2::FocusListLiftingStrategy2( const ParityGame &game,
+    bool alternate, verti max_size, long long max_lifts )
+    : LiftingStrategy2(), max_lift_attempts_(max_lifts), phase_(1),
+      num_lift_attempts_(0), lls_(game, alternate)
 {
-    (void)spm;  // unused
+    focus_list_.reserve(max_size);
+}
+
+verti FocusListLiftingStrategy2::pop()
+{
+    return phase_ == 1 ? phase1() : phase2();
+}
+
+verti FocusListLiftingStrategy2::phase1()
+{
+    if (focus_list_.size() == focus_list_.capacity())
+    {
+        /* Switch to phase 2: */
+        phase_ = 2;
+        num_lift_attempts_ = 0;
+        read_pos_ = write_pos_ = focus_list_.begin();
+        info("Switching to focus list of size %d.", (int)focus_list_.size());
+        return phase2();
+    }
+
+    /* Every vertex popped is lifted, so it goes on the focus list: */
+    verti v = lls_.pop();
+    if (v != NO_VERTEX)
+    {
+        focus_list_.push_back(std::make_pair(v, initial_credit));
+    }
+    return v;
+}
 
+verti FocusListLiftingStrategy2::phase2()
+{
+    for (;;)
+    {
+        // Check if we've reached the end of the focus list; if so, restart:
+        if (read_pos_ == focus_list_.end())
+        {
+            focus_list_.erase(write_pos_, focus_list_.end());
+            read_pos_ = write_pos_ = focus_list_.begin();
+        }
+
+        if (focus_list_.empty() || num_lift_attempts_ >= max_lift_attempts_)
+        {
+            if (focus_list_.empty())
+            {
+                info("Focus list exhausted.");
+            }
+            else
+            {
+                info( "Maximum lift attempts (%lld) on focus list reached.",
+                    max_lift_attempts_ );
+                focus_list_.clear();
+            }
+
+            /* Switch to phase 1 */
+            phase_ = 1;
+            num_lift_attempts_ = 0;
+            return phase1();
+        }
+        ++num_lift_attempts_;
+
+        // Lift the current vertex if it is dirty, or adjust its credit:
+        focus_list::value_type cur = *read_pos_++;
+        if (lls_.queued(cur.first))
+        {
+            lls_.erase(cur.first);
+            cur.second += credit_increase;
+            *write_pos_++ = cur;
+            return cur.first;
+        }
+        if (cur.second > 0)
+        {
+            cur.second /= 2;
+            *write_pos_++ = cur;
+        }
+        // else, drop from list.
+    }
+}
+
+bool FocusListLiftingStrategyFactory::supports_version(int version)
+{
+    return version == 1 || version == 2;
+}
+
+verti FocusListLiftingStrategyFactory::max_size(const ParityGame &game) const
+{
     /* Ratio is absolute value if >1, or a fraction of the size of the game's
        vertex set if <= 1. */
     verti V = game.graph().V();
     verti max_size  = (size_ratio_ > 1) ? size_ratio_ : size_ratio_*V;
     if (max_size == 0) max_size = 1;
     if (max_size >  V) max_size = V;
-    verti max_lifts = (verti)(lift_ratio_ * max_size);
+    return max_size;
+}
+
+LiftingStrategy *FocusListLiftingStrategyFactory::create(
+    const ParityGame &game, const SmallProgressMeasures &spm )
+{
+    (void)spm;  // unused
+    verti size = max_size(game);
     return new FocusListLiftingStrategy(
-        game, alternate_, max_size, max_lifts );
+        game, alternate_, size, (long long)(lift_ratio_ * size) );
+}
+
+LiftingStrategy2 *FocusListLiftingStrategyFactory::create2(
+    const ParityGame &game, const SmallProgressMeasures &spm )
+{
+    (void)spm;  // unused
+    verti size = max_size(game);
+    return new FocusListLiftingStrategy2(
+        game, alternate_, size, (long long)(lift_ratio_ * size) );
 }
@@ -80,6 +80,47 @@ private:
     focus_list::iterator write_pos_;    //!< current position in the focus list
 };
 
+/*! \ingroup LiftingStrategies
+
+    Version 2 implementation of the focus list lifting strategy. The first
+    phase is delegated to a LinearLiftingStrategy2 instance, which keeps track
+    of dirty vertices. In the second phase, vertices on the focus list that
+    are not dirty are skipped (and their credit decreased) without attempting
+    to lift them.
+
+    \see FocusListLiftingStrategy
+*/
+class FocusListLiftingStrategy2 : public LiftingStrategy2, public virtual Logger
+{
+public:
+    //! \see FocusListLiftingStrategy::FocusListLiftingStrategy()
+    FocusListLiftingStrategy2( const ParityGame &game, bool alternate,
+                               verti max_size, long long max_lifts );
+
+    void push(verti v) { lls_.push(v); }
+    void bump(verti v) { (void)v; }
+    verti pop();
+
+protected:
+    verti phase1();
+    verti phase2();
+
+private:
+    typedef std::vector<std::pair<verti, unsigned> > focus_list;
+
+    long long max_lift_attempts_;       //!< maximum lift attempts per list
+    int phase_;                         //!< current phase
+    long long num_lift_attempts_;       //!< number of vertices visited
+
+    // For phase 1 (and tracking dirty vertices):
+    LinearLiftingStrategy2 lls_;        //!< strategy for phase 1
+
+    // For phase 2:
+    focus_list focus_list_;             //!< nodes on the focus list
+    focus_list::iterator read_pos_;     //!< current position in the focus list
+    focus_list::iterator write_pos_;    //!< current position in the focus list
+};
+
 /*! \ingroup LiftingStrategies
     Factory class for FocusListLiftingStrategy instances. */
 class FocusListLiftingStrategyFactory : public LiftingStrategyFactory
@@ -104,11 +145,20 @@ public:
           size_ratio_(size_ratio > 0 ? size_ratio :  0.1),
           lift_ratio_(lift_ratio > 0 ? lift_ratio : 10.0) { };
 
+    bool supports_version(int version);
+
     //! Return a new FocusListLiftingStrategy instance.
     LiftingStrategy *create( const ParityGame &game,
                              const SmallProgressMeasures &spm );
 
+    //! Return a new FocusListLiftingStrategy2 instance.
+    LiftingStrategy2 *create2( const ParityGame &game,
+                               const SmallProgressMeasures &spm );
+
 private:
+    //! Returns the maximum focus list size for `game`.
+    verti max_size(const ParityGame &game) const;
+
     const bool   alternate_;
     const double size_ratio_, lift_ratio_;
 };
@@ -7,29 +7,65 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#if defined(__unix__) || defined(__linux__)
+#define POSIX
+#endif
+
 #include "Graph.h"
 #include "SCC.h"
 #include "Logger.h"
 #include "shuffle.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
+#include <fstream>
 #include <utility>
 #include <vector>
 
+#ifdef POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
+
 StaticGraph::StaticGraph()
     : successors_(NULL), predecessors_(NULL),
-      successor_index_(NULL), predecessor_index_(NULL)
+      successor_index_(NULL), predecessor_index_(NULL),
+      mapping_(NULL), mapping_size_(0)
 {
     reset(0, 0, EDGE_NONE);
 }
 
 StaticGraph::~StaticGraph()
 {
-    delete[] successors_;
-    delete[] predecessors_;
-    delete[] successor_index_;
-    delete[] predecessor_index_;
+    deallocate();
+}
+
+void StaticGraph::deallocate()
+{
+    if (mapping_)
+    {
+#ifdef POSIX
+        munmap(mapping_, mapping_size_);
+#endif
+        mapping_ = NULL;
+        mapping_size_ = 0;
+    }
+    else
+    {
+        delete[] successors_;
+        delete[] predecessors_;
+        delete[] successor_index_;
+        delete[] predecessor_index_;
+    }
+    successors_ = predecessors_ = NULL;
+    successor_index_ = predecessor_index_ = NULL;
 }
 
 void StaticGraph::clear()
@@ -39,15 +75,12 @@ void StaticGraph::clear()
 
 void StaticGraph::reset(verti V, edgei E, EdgeDirection edge_dir)
 {
+    deallocate();
+
     V_ = V;
     E_ = E;
     edge_dir_ = edge_dir;
 
-    delete[] successors_;
-    delete[] predecessors_;
-    delete[] successor_index_;
-    delete[] predecessor_index_;
-
     if ((edge_dir & EDGE_SUCCESSOR))
     {
         successors_      = new verti[E];
@@ -85,10 +118,148 @@ static bool edge_cmp_backward( const std::pair<verti, verti> &a,
     return a.second < b.second || (a.second == b.second && a.first < b.first);
 }
 
+#ifdef WITH_THREADS
+/*! Minimum number of edges for which compressed edge lists are built using
+    multiple threads; below this, the threading overhead isn't worth it. */
+static const edgei min_parallel_edges = 1 << 16;
+
+/*! Returns whether a graph with `E` edges should be built in parallel. */
+static bool build_in_parallel(edgei E)
+{
+    return E >= min_parallel_edges && omp_get_max_threads() > 1;
+}
+
+/*! Sorts the lists `list[index[v]:index[v + 1]]` for all `v` < `V`. */
+static void sort_lists(verti V, verti *list, const edgei *index)
+{
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (verti v = 0; v < V; ++v)
+    {
+        std::sort(list + index[v], list + index[v + 1]);
+    }
+}
+#endif
+
+/*! Computes `index` (of size V + 1) from the counts stored at `index[1:V+1]`.*/
+static void prefix_sum(verti V, edgei *index)
+{
+    index[0] = 0;
+    for (verti v = 0; v < V; ++v) index[v + 1] += index[v];
+}
+
+/*! Builds successor lists in compressed form from an edge list in O(V + E)
+    time, by counting sort. Successor lists are sorted by increasing index.
+
+    Edges are first distributed by successor, and then (visiting successors in
+    increasing order) by predecessor, so no comparison sort is needed. */
+static void make_successor_lists( verti V, const StaticGraph::edge_list &edges,
+                                  verti *successors, edgei *successor_index )
+{
+    const edgei E = (edgei)edges.size();
+    std::fill(successor_index, successor_index + V + 1, 0);
+
+#ifdef WITH_THREADS
+    if (build_in_parallel(E))
+    {
+        #pragma omp parallel for
+        for (edgei e = 0; e < E; ++e)
+        {
+            __atomic_fetch_add( &successor_index[edges[e].first + 1], 1,
+                                __ATOMIC_RELAXED );
+        }
+        prefix_sum(V, successor_index);
+        std::vector<edgei> pos(successor_index, successor_index + V);
+        #pragma omp parallel for
+        for (edgei e = 0; e < E; ++e)
+        {
+            successors[ __atomic_fetch_add( &pos[edges[e].first], 1,
+                                            __ATOMIC_RELAXED ) ] = edges[e].second;
+        }
+        sort_lists(V, successors, successor_index);
+        return;
+    }
+#endif
+
+    // Count successors and predecessors:
+    std::vector<edgei> pred_end(V + 1, 0);
+    for (edgei e = 0; e < E; ++e)
+    {
+        ++successor_index[edges[e].first + 1];
+        ++pred_end[edges[e].second + 1];
+    }
+    prefix_sum(V, successor_index);
+    prefix_sum(V, &pred_end[0]);
+
+    // Distribute predecessors by successor:
+    std::vector<verti> preds(E);
+    for (edgei e = 0; e < E; ++e)
+    {
+        preds[pred_end[edges[e].second]++] = edges[e].first;
+    }
+
+    // Distribute successors by predecessor, in order of increasing successor:
+    std::vector<edgei> pos(successor_index, successor_index + V);
+    edgei e = 0;
+    for (verti w = 0; w < V; ++w)
+    {
+        for ( ; e < pred_end[w]; ++e) successors[pos[preds[e]]++] = w;
+    }
+}
+
+/*! Builds sorted predecessor lists in compressed form from the given
+    successor lists in O(V + E) time. */
+static void make_predecessor_lists( verti V,
+    const verti *successors, const edgei *successor_index,
+    verti *predecessors, edgei *predecessor_index )
+{
+    const edgei E = successor_index[V];
+    std::fill(predecessor_index, predecessor_index + V + 1, 0);
+
+#ifdef WITH_THREADS
+    if (build_in_parallel(E))
+    {
+        #pragma omp parallel for
+        for (edgei e = 0; e < E; ++e)
+        {
+            __atomic_fetch_add( &predecessor_index[successors[e] + 1], 1,
+                                __ATOMIC_RELAXED );
+        }
+        prefix_sum(V, predecessor_index);
+        std::vector<edgei> pos(predecessor_index, predecessor_index + V);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (verti v = 0; v < V; ++v)
+        {
+            for (edgei e = successor_index[v]; e < successor_index[v + 1]; ++e)
+            {
+                predecessors[ __atomic_fetch_add( &pos[successors[e]], 1,
+                                                  __ATOMIC_RELAXED ) ] = v;
+            }
+        }
+        sort_lists(V, predecessors, predecessor_index);
+        return;
+    }
+#endif
+
+    /* Count predecessors, then distribute edges by successor. Since
+       vertices are processed in order, predecessor lists end up sorted. */
+    for (edgei e = 0; e < E; ++e) ++predecessor_index[successors[e] + 1];
+    prefix_sum(V, predecessor_index);
+    std::vector<edgei> pos(predecessor_index, predecessor_index + V);
+    for (verti v = 0; v < V; ++v)
+    {
+        for (edgei e = successor_index[v]; e < successor_index[v + 1]; ++e)
+        {
+            predecessors[pos[successors[e]]++] = v;
+        }
+    }
+}
+
 void StaticGraph::make_random_scc(edge_list &edges)
 {
+    /* Random numbers are drawn per component, so components must be found in
+       the same order regardless of the number of threads: */
     SCCs sccs;
-    decompose_graph(*this, sccs);
+    decompose_graph_sequential(*this, sccs);
 
     /* If we happen to have a single SCC by luck, we are done too: */
     if (sccs.size() <= 1) return;
@@ -307,13 +478,15 @@ void StaticGraph::assign(const StaticGraph &graph)
     }
 }
 
-void StaticGraph::assign(edge_list edges, EdgeDirection edge_dir, verti V)
+void StaticGraph::assign( const edge_list &edges, EdgeDirection edge_dir,
+                          verti V )
 {
     // Find number of vertices
     if (V == NO_VERTEX)
     {
         V = 0;
-        for (edge_list::iterator it = edges.begin(); it != edges.end(); ++it)
+        for ( edge_list::const_iterator it = edges.begin();
+              it != edges.end(); ++it )
         {
             if (it->first  >= V) V = it->first  + 1;
             if (it->second >= V) V = it->second + 1;
@@ -323,46 +496,40 @@ void StaticGraph::assign(edge_list edges, EdgeDirection edge_dir, verti V)
     edgei E = (edgei)edges.size();
     assert(E == edges.size());  /* detect integer overflow */
 
-    /* Reallocate memory */
-    reset(V, E, edge_dir);
-
-    if (edge_dir_ & EDGE_SUCCESSOR)
-    {
-        /* Sort edges by predecessor first, successor second */
-        if (!is_sorted(edges.begin(), edges.end(), edge_cmp_forward))
-        {
-            std::sort(edges.begin(), edges.end(), edge_cmp_forward);
-        }
+    /* Build successor lists; predecessors are derived from these. */
+    verti *successors      = new verti[E];
+    edgei *successor_index = new edgei[V + 1];
+    make_successor_lists(V, edges, successors, successor_index);
+    assign(V, E, successors, successor_index, edge_dir);
+}
 
-        /* Create successor index */
-        edgei pos = 0;
-        for (verti v = 0; v < V; ++v)
-        {
-            while (pos < E && edges[pos].first < v) ++pos;
-            successor_index_[v] = pos;
-        }
-        successor_index_[V] = E;
+void StaticGraph::assign( verti V, edgei E, verti *successors,
+                          edgei *successor_index, EdgeDirection edge_dir )
+{
+    assert(successor_index[V] == E);
 
-        /* Create successor list */
-        for (edgei e = 0; e < E; ++e) successors_[e] = edges[e].second;
-    }
+    deallocate();
+    V_ = V;
+    E_ = E;
+    edge_dir_ = edge_dir;
 
     if (edge_dir_ & EDGE_PREDECESSOR)
     {
-        /* Sort edges by successor first, predecessor second */
-        std::sort(edges.begin(), edges.end(), edge_cmp_backward);
-
-        /* Create predecessor index */
-        edgei pos = 0;
-        for (verti v = 0; v < V; ++v)
-        {
-            while (pos < E && edges[pos].second < v) ++pos;
-            predecessor_index_[v] = pos;
-        }
-        predecessor_index_[V] = E;
+        predecessors_      = new verti[E];
+        predecessor_index_ = new edgei[V + 1];
+        make_predecessor_lists( V, successors, successor_index,
+                                predecessors_, predecessor_index_ );
+    }
 
-        /* Create predecessor list */
-        for (edgei e = 0; e < E; ++e) predecessors_[e] = edges[e].first;
+    if (edge_dir_ & EDGE_SUCCESSOR)
+    {
+        successors_      = successors;
+        successor_index_ = successor_index;
+    }
+    else
+    {
+        delete[] successors;
+        delete[] successor_index;
     }
 }
 
@@ -458,11 +625,27 @@ StaticGraph::edge_list StaticGraph::get_edges() const
     return result;
 }
 
+/* In the raw format, the edge direction is stored in a field of the same size
+   as the edge count, so that the edge arrays that follow the header are
+   aligned. (With 32-bit indices, this is the size of the enumeration.) */
+typedef edgei raw_edge_dir_t;
+
+/*! Checks a raw graph header read from `what`, aborting if it is invalid. */
+static void check_raw_header(raw_edge_dir_t edge_dir, const char *what)
+{
+    if (edge_dir > StaticGraph::EDGE_BIDIRECTIONAL)
+    {
+        Logger::fatal( "%s does not contain a raw graph with %d-bit indices!",
+                       what, (int)(8*sizeof(verti)) );
+    }
+}
+
 void StaticGraph::write_raw(std::ostream &os) const
 {
+    raw_edge_dir_t edge_dir = edge_dir_;
     os.write((const char*)&V_, sizeof(V_));
     os.write((const char*)&E_, sizeof(E_));
-    os.write((const char*)&edge_dir_, sizeof(edge_dir_));
+    os.write((const char*)&edge_dir, sizeof(edge_dir));
     if (edge_dir_ & EDGE_SUCCESSOR)
     {
         os.write((const char*)successors_, sizeof(verti)*E_);
@@ -479,13 +662,14 @@ void StaticGraph::read_raw(std::istream &is)
 {
     verti V;
     edgei E;
-    EdgeDirection edge_dir;
+    raw_edge_dir_t edge_dir;
 
     is.read((char*)&V, sizeof(V));
     is.read((char*)&E, sizeof(E));
     is.read((char*)&edge_dir, sizeof(edge_dir));
+    check_raw_header(edge_dir, "Input");
 
-    reset(V, E, edge_dir);
+    reset(V, E, (EdgeDirection)edge_dir);
 
     if (edge_dir & EDGE_SUCCESSOR)
     {
@@ -499,6 +683,62 @@ void StaticGraph::read_raw(std::istream &is)
     }
 }
 
+size_t StaticGraph::map_raw(const char *path)
+{
+#ifdef POSIX
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) Logger::fatal("Could not open file \"%s\"!", path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) Logger::fatal("Could not stat file \"%s\"!", path);
+    size_t size = st.st_size;
+    void *data = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       fd, 0 );
+    close(fd);
+    if (data == MAP_FAILED) Logger::fatal("Could not map file \"%s\"!", path);
+
+    verti V;
+    edgei E;
+    raw_edge_dir_t edge_dir;
+    const char *p = (const char*)data;
+    size_t pos = sizeof(V) + sizeof(E) + sizeof(edge_dir);
+    if (size < pos) Logger::fatal("File \"%s\" is truncated!", path);
+    memcpy(&V, p, sizeof(V));
+    memcpy(&E, p + sizeof(V), sizeof(E));
+    memcpy(&edge_dir, p + sizeof(V) + sizeof(E), sizeof(edge_dir));
+    check_raw_header(edge_dir, path);
+
+    // Point edge arrays directly into the mapped data:
+    deallocate();
+    V_ = V;
+    E_ = E;
+    edge_dir_ = (EdgeDirection)edge_dir;
+    mapping_ = data;
+    mapping_size_ = size;
+    if (edge_dir & EDGE_SUCCESSOR)
+    {
+        successors_ = (verti*)(p + pos);
+        pos += sizeof(verti)*E;
+        successor_index_ = (edgei*)(p + pos);
+        pos += sizeof(edgei)*(V + 1);
+    }
+    if (edge_dir & EDGE_PREDECESSOR)
+    {
+        predecessors_ = (verti*)(p + pos);
+        pos += sizeof(verti)*E;
+        predecessor_index_ = (edgei*)(p + pos);
+        pos += sizeof(edgei)*(V + 1);
+    }
+    if (size < pos) Logger::fatal("File \"%s\" is truncated!", path);
+    return pos;
+#else
+    // Fall back to reading the file:
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    if (!ifs) Logger::fatal("Could not open file \"%s\"!", path);
+    read_raw(ifs);
+    return ifs.tellg();
+#endif
+}
+
 void StaticGraph::swap(StaticGraph &g)
 {
     if (this == &g) return;
@@ -509,6 +749,8 @@ void StaticGraph::swap(StaticGraph &g)
     std::swap(successor_index_, g.successor_index_);
     std::swap(predecessor_index_, g.predecessor_index_);
     std::swap(edge_dir_, g.edge_dir_);
+    std::swap(mapping_, g.mapping_);
+    std::swap(mapping_size_, g.mapping_size_);
 }
 
 #ifdef WITH_THREADS
@@ -23,8 +23,13 @@
 #include "compatibility.h"
 
 // Note: these should be unsigned types; some algorithms depend on it!
+#ifdef WITH_64BIT_INDICES
+typedef compat_uint64_t verti;    //!< type used to number vertices
+typedef compat_uint64_t edgei;    //!< type used to number edges
+#else
 typedef compat_uint32_t verti;    //!< type used to number vertices
 typedef compat_uint32_t edgei;    //!< type used to number edges
+#endif
 
 #define NO_VERTEX ((verti)-1)
 
@@ -99,10 +104,24 @@ public:
     /*! Reset the graph to a copy of `graph`. */
     void assign(const StaticGraph &graph);
 
-    /*! Reset the graph based on the given edge structure.
+    /*! Reset the graph based on the given edge structure. The edge list is
+        not modified (or copied); compressed edge lists are constructed by
+        counting sort in O(V + E) time.
         @param V the number of vertices in the graph.
                  By default, the value is calculated from the edge set. */
-    void assign(edge_list edges, EdgeDirection edge_dir, verti V = NO_VERTEX);
+    void assign( const edge_list &edges, EdgeDirection edge_dir,
+                 verti V = NO_VERTEX );
+
+    /*! Reset the graph based on successor lists in compressed form: the
+        successors of vertex `v` are stored in increasing order from
+        `successors[successor_index[v]]` up to (but excluding)
+        `successors[successor_index[v + 1]]`, and `successor_index[V]` is E.
+
+        This takes ownership of both arrays, which must have been allocated
+        with new[], and avoids the construction of an intermediate edge list.
+        Predecessor lists are derived from the successor lists if required. */
+    void assign( verti V, edgei E, verti *successors, edgei *successor_index,
+                 EdgeDirection edge_dir );
 
     /*! Convert the graph into a list of edges. */
     edge_list get_edges() const;
@@ -186,6 +205,19 @@ public:
     /*! Read raw graph data from input stream */
     void read_raw(std::istream &is);
 
+    /*! Read raw graph data from the file at `path` by mapping the edge arrays
+        into memory instead of copying them. The mapping is private, so
+        changes to the graph are never written back to the file.
+
+        Returns the file offset just past the graph data (where e.g. the
+        parity game data starts). Exits with a fatal error if the file cannot
+        be mapped. */
+    size_t map_raw(const char *path);
+
+    /*! Returns whether the edge arrays are mapped from a file (in which case
+        they are not owned by the graph). */
+    bool mapped() const { return mapping_ != NULL; }
+
     //!@}
 
     //!\name Data access
@@ -274,6 +306,10 @@ protected:
         with `V` vertices and `E` edges. */
     void reset(verti V, edgei E, EdgeDirection edge_dir);
 
+    /*! Frees the edge arrays, or unmaps them if they were mapped from a file
+        by map_raw(). */
+    void deallocate();
+
     /*! Reset the graph to the subgraph induced by the given vertex set, using
         the given map data structure to create the vertex mapping. */
     template<class ForwardIterator, class VertexMapT>
@@ -306,6 +342,11 @@ private:
     /*! Direction of stored edges. */
     EdgeDirection edge_dir_;
 
+    /*! Memory mapped by map_raw() (of size `mapping_size_`) which contains
+        the edge arrays, or NULL if the arrays were allocated with new[]. */
+    void *mapping_;
+    size_t mapping_size_;
+
 private:
     /* This is a bit of a hack to allow the small progress measures code to
        do a preprocessing pass for nodes with self-loops. */
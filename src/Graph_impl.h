@@ -73,7 +73,7 @@ void StaticGraph::make_subgraph( const StaticGraph &graph,
                                  StaticGraph::EdgeDirection edge_dir )
 {
     // FIXME: determine which cut-off value works best:
-    if (std::distance(vertices_begin, vertices_end) < graph.V()/3)
+    if ((verti)std::distance(vertices_begin, vertices_end) < graph.V()/3)
     {
         HASH_MAP(verti, verti) map;
         return make_subgraph(graph, vertices_begin,
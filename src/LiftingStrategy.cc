@@ -51,7 +51,8 @@ const char *LiftingStrategyFactory::usage()
 "   Maximum measure propagation; a variant of the predecessor lifting strategy\n"
 "   that prefers to lift vertices with higher progress measures.\n"
 "   - order: tie-breaking lifting order: 0 (queue-like), 1 (stack-like)\n"
-"            or 2 (heap order) (default: 2)\n"
+"            or 2 (heap order) (default: 2), or 3 to use a bucket queue\n"
+"            keyed on leading vector components (approximate order)\n"
 "\n"
 "maxstep:order\n"
 "   Maximum step variant of maximum measure propagation.\n"
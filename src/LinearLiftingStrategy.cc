@@ -75,9 +75,63 @@ verti LinearLiftingStrategy::next()
     return vertex_;
 }
 
+LinearLiftingStrategy2::LinearLiftingStrategy2(
+    const ParityGame &game, bool alternate )
+    : LiftingStrategy2(), alternate_(alternate), dir_(0), pos_(0),
+      queued_(0, game.graph().V())
+{
+}
+
+verti LinearLiftingStrategy2::pop()
+{
+    if (queued_.empty()) return NO_VERTEX;
+
+    verti v;
+    if (dir_ == 0)  // forward
+    {
+        v = *queued_.lower_bound(pos_);
+        if (v == queued_.range_end)
+        {
+            if (!alternate_)
+            {
+                v = *queued_.begin();
+            }
+            else
+            {
+                dir_ = 1;
+                v = queued_.prev(queued_.range_end);
+            }
+        }
+    }
+    else  // backward
+    {
+        v = queued_.prev(pos_);
+        if (v == queued_.range_end)
+        {
+            dir_ = 0;
+            v = *queued_.begin();
+        }
+    }
+    pos_ = dir_ == 0 ? v + 1 : v;
+    queued_.erase(v);
+    return v;
+}
+
+bool LinearLiftingStrategyFactory::supports_version(int version)
+{
+    return version == 1 || version == 2;
+}
+
 LiftingStrategy *LinearLiftingStrategyFactory::create(
     const ParityGame &game, const SmallProgressMeasures &spm )
 {
     (void)spm;  // unused
     return new LinearLiftingStrategy(game, alternate_);
 }
+
+LiftingStrategy2 *LinearLiftingStrategyFactory::create2(
+    const ParityGame &game, const SmallProgressMeasures &spm )
+{
+    (void)spm;  // unused
+    return new LinearLiftingStrategy2(game, alternate_);
+}
@@ -11,6 +11,7 @@
 #define LINEAR_LIFTING_STRATEGY_H_INCLUDED
 
 #include "SmallProgressMeasures.h"
+#include "DenseSet.h"
 
 /*! \ingroup LiftingStrategies
 
@@ -38,6 +39,39 @@ private:
     verti failed_lifts_;        //!< number of consecutive failed lift attempts
 };
 
+/*! \ingroup LiftingStrategies
+
+    Version 2 implementation of the linear lifting strategy. Dirty vertices are
+    kept in a bitset, and popped in the order in which a linear sweep over the
+    vertices would encounter them, so stable vertices are skipped instead of
+    causing failed lifting attempts.
+
+    \see LinearLiftingStrategy
+*/
+class LinearLiftingStrategy2 : public LiftingStrategy2
+{
+public:
+    LinearLiftingStrategy2(const ParityGame &game, bool alternate);
+
+    void push(verti v) { queued_.insert(v); }
+    void bump(verti v) { (void)v; }
+    verti pop();
+
+    bool alternate() const { return alternate_; }
+
+    //! Returns whether vertex `v` is queued.
+    bool queued(verti v) const { return queued_.count(v) != 0; }
+
+    //! Removes vertex `v` from the queue.
+    void erase(verti v) { queued_.erase(v); }
+
+private:
+    const bool alternate_;      //!< alternate direction after each pass
+    bool dir_;                  //!< current direction of iteration
+    verti pos_;                 //!< current position of iteration
+    DenseSet<verti> queued_;    //!< set of dirty vertices
+};
+
 /*! \ingroup LiftingStrategies
     A factory class for LinearLiftingStrategy instances. */
 class LinearLiftingStrategyFactory : public LiftingStrategyFactory
@@ -46,10 +80,18 @@ public:
     LinearLiftingStrategyFactory(bool alternate = false)
         : alternate_(alternate) { };
 
+    bool supports_version(int version);
+
+    bool alternate() const { return alternate_; }
+
     //! Return a new LinearLiftingStrategy instance.
     LiftingStrategy *create( const ParityGame &game,
                              const SmallProgressMeasures &spm );
 
+    //! Return a new LinearLiftingStrategy2 instance.
+    LiftingStrategy2 *create2( const ParityGame &game,
+                               const SmallProgressMeasures &spm );
+
 private:
     const bool alternate_;
 };
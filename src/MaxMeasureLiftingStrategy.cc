@@ -99,7 +99,7 @@ void MaxMeasureLiftingStrategy2::swap(verti i, verti j)
 
 void MaxMeasureLiftingStrategy2::push(verti v)
 {
-    Logger::debug("push(%d)", v);
+    Logger::debug("push(%ld)", (long)v);
     assert(pq_pos_[v] == NO_VERTEX);
     pq_[pq_size_] = v;
     pq_pos_[v] = pq_size_;
@@ -110,7 +110,7 @@ void MaxMeasureLiftingStrategy2::push(verti v)
 
 void MaxMeasureLiftingStrategy2::bump(verti v)
 {
-    Logger::debug("bump(%d)", v);
+    Logger::debug("bump(%ld)", (long)v);
     bumped_.push_back(pq_pos_[v]);
 }
 
@@ -163,7 +163,7 @@ verti MaxMeasureLiftingStrategy2::pop()
 
     // Extract top element from the heap.
     verti v = pq_[0];
-    Logger::debug("pop() -> %d", v);
+    Logger::debug("pop() -> %ld", (long)v);
     pq_pos_[v] = NO_VERTEX;
     if (--pq_size_ > 0)
     {
@@ -229,10 +229,13 @@ int MaxMeasureLiftingStrategy2::cmp(verti i, verti j)
     case MAX_STEP:
 #ifdef DEBUG
         // We assume vertices are only queued when they can be lifted;
-        // i.e. their value is less than (or equal to) their successor:
-        assert(spm_.vector_cmp(v, spm_.get_successor(v), spm_.len(v))
+        // i.e. their value is less than (or equal to) their successor, or
+        // they were attracted to top while queued:
+        assert(spm_.is_top(v) ||
+               spm_.vector_cmp(v, spm_.get_successor(v), spm_.len(v))
                     < spm_.compare_strict(v));
-        assert(spm_.vector_cmp(w, spm_.get_successor(w), spm_.len(w))
+        assert(spm_.is_top(w) ||
+               spm_.vector_cmp(w, spm_.get_successor(w), spm_.len(w))
                     < spm_.compare_strict(w));
 #endif
         d = cmp_step( spm_.vec(v), spm_.vec(spm_.get_successor(v)),
@@ -281,6 +284,134 @@ bool MaxMeasureLiftingStrategy2::check()
     return true;
 }
 
+BucketMaxMeasureLiftingStrategy2::BucketMaxMeasureLiftingStrategy2(
+    const ParityGame &game, const SmallProgressMeasures &spm,
+    MaxMeasureLiftingStrategy2::Metric metric )
+        : LiftingStrategy2(), spm_(spm), metric_(metric), digits_(0),
+          bucket_(new verti[game.graph().V()]),
+          prev_(new verti[game.graph().V()]),
+          next_(new verti[game.graph().V()]),
+          summary_top_(0)
+{
+    const verti V = game.graph().V();
+    std::fill(&bucket_[0], &bucket_[V], NO_VERTEX);
+
+    /* Use as many leading components as possible while keeping the number of
+       buckets linear in the number of vertices. Components are less than
+       their bound (even if the bound is decreased later on). */
+    const long long max_buckets = (long long)V + 1;
+    long long num_keys = 1;
+    while ( digits_ < spm.len() &&
+            num_keys*(long long)spm.M()[digits_] <= max_buckets )
+    {
+        radix_.push_back(spm.M()[digits_]);
+        num_keys *= radix_.back();
+        ++digits_;
+    }
+    top_bucket_ = (verti)num_keys;
+
+    const size_t num_buckets = (size_t)top_bucket_ + 1;
+    head_.assign(num_buckets, NO_VERTEX);
+    tail_.assign(num_buckets, NO_VERTEX);
+    used_.assign((num_buckets + 63)/64, 0);
+    summary_.assign((used_.size() + 63)/64, 0);
+}
+
+BucketMaxMeasureLiftingStrategy2::~BucketMaxMeasureLiftingStrategy2()
+{
+    delete[] bucket_;
+    delete[] prev_;
+    delete[] next_;
+}
+
+verti BucketMaxMeasureLiftingStrategy2::bucket(verti v) const
+{
+    const bool minimize = metric_ == MaxMeasureLiftingStrategy2::MIN_VALUE;
+    const verti *vec_w = spm_.vec(spm_.get_successor(v));
+    if (spm_.is_top(vec_w)) return minimize ? 0 : top_bucket_;
+
+    if (metric_ == MaxMeasureLiftingStrategy2::MAX_STEP)
+    {
+        /* Key on the step size in the leading component (lifting a vertex
+           without components always results in top). */
+        if (spm_.len(v) == 0 || digits_ == 0) return top_bucket_;
+        const verti *vec_v = spm_.vec(v);
+        verti step = vec_w[0] > vec_v[0] ? vec_w[0] - vec_v[0] : 0;
+        return step*(top_bucket_/radix_[0]);
+    }
+
+    verti key = 0;
+    for (int i = 0; i < digits_; ++i) key = key*radix_[i] + vec_w[i];
+    return minimize ? top_bucket_ - key : key;
+}
+
+void BucketMaxMeasureLiftingStrategy2::insert(verti v, verti b)
+{
+    bucket_[v] = b;
+    prev_[v] = tail_[b];
+    next_[v] = NO_VERTEX;
+    if (tail_[b] == NO_VERTEX)
+    {
+        head_[b] = v;
+        used_[b/64] |= (compat_uint64_t)1 << (b%64);
+        summary_[b/64/64] |= (compat_uint64_t)1 << (b/64%64);
+        if (b/64/64 > summary_top_) summary_top_ = b/64/64;
+    }
+    else
+    {
+        next_[tail_[b]] = v;
+    }
+    tail_[b] = v;
+}
+
+void BucketMaxMeasureLiftingStrategy2::remove(verti v)
+{
+    const verti b = bucket_[v];
+    if (prev_[v] == NO_VERTEX) head_[b] = next_[v];
+    else next_[prev_[v]] = next_[v];
+    if (next_[v] == NO_VERTEX) tail_[b] = prev_[v];
+    else prev_[next_[v]] = prev_[v];
+    if (head_[b] == NO_VERTEX)
+    {
+        used_[b/64] &= ~((compat_uint64_t)1 << (b%64));
+        if (used_[b/64] == 0)
+        {
+            summary_[b/64/64] &= ~((compat_uint64_t)1 << (b/64%64));
+        }
+    }
+    bucket_[v] = NO_VERTEX;
+}
+
+void BucketMaxMeasureLiftingStrategy2::push(verti v)
+{
+    assert(bucket_[v] == NO_VERTEX);
+    insert(v, bucket(v));
+}
+
+void BucketMaxMeasureLiftingStrategy2::bump(verti v)
+{
+    assert(bucket_[v] != NO_VERTEX);
+    verti b = bucket(v);
+    if (b != bucket_[v])
+    {
+        remove(v);
+        insert(v, b);
+    }
+}
+
+verti BucketMaxMeasureLiftingStrategy2::pop()
+{
+    while (summary_top_ > 0 && summary_[summary_top_] == 0) --summary_top_;
+    compat_uint64_t bits = summary_[summary_top_];
+    if (bits == 0) return NO_VERTEX;
+
+    verti w = 64*summary_top_ + (63 - compat_clz64(bits));
+    verti b = 64*w + (63 - compat_clz64(used_[w]));
+    verti v = head_[b];
+    remove(v);
+    return v;
+}
+
 bool MaxMeasureLiftingStrategyFactory::supports_version(int version)
 {
     return version == 2;
@@ -295,5 +426,9 @@ LiftingStrategy *MaxMeasureLiftingStrategyFactory::create(
 LiftingStrategy2 *MaxMeasureLiftingStrategyFactory::create2(
     const ParityGame &game, const SmallProgressMeasures &spm )
 {
+    if (order_ == MaxMeasureLiftingStrategy2::BUCKET)
+    {
+        return new BucketMaxMeasureLiftingStrategy2(game, spm, metric_);
+    }
     return new MaxMeasureLiftingStrategy2(game, spm, order_, metric_);
 }
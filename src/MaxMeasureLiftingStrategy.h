@@ -31,7 +31,7 @@
 class MaxMeasureLiftingStrategy2 : public LiftingStrategy2
 {
 public:
-    enum Order { QUEUE = 0, STACK = 1, HEAP = 2 }; 
+    enum Order { QUEUE = 0, STACK = 1, HEAP = 2, BUCKET = 3 };
     enum Metric { MAX_VALUE = 0, MAX_STEP = 1, MIN_VALUE = 2 };
 
     MaxMeasureLiftingStrategy2( const ParityGame &game,
@@ -84,6 +84,69 @@ private:
     std::vector<verti> bumped_;
 };
 
+/*! \ingroup LiftingStrategies
+
+    A variant of MaxMeasureLiftingStrategy2 that uses a bucket queue instead of
+    a binary heap, which is selected with the BUCKET order.
+
+    Each queued vertex is kept in a bucket determined by the leading components
+    of its successor's progress measure vector, interpreted as digits of a
+    mixed-radix number (as many components as fit in roughly V buckets), with
+    an extra bucket for vertices whose successor is top. Buckets are doubly
+    linked lists, so a bumped vertex is moved to its new bucket in constant
+    time, and the highest non-empty bucket is found with a two-level bitmap.
+
+    Since only a prefix of each vector is considered, the extraction order
+    approximates that of the heap-based implementation; vertices in the same
+    bucket are extracted in FIFO order.
+*/
+class BucketMaxMeasureLiftingStrategy2 : public LiftingStrategy2
+{
+public:
+    BucketMaxMeasureLiftingStrategy2(
+        const ParityGame &game, const SmallProgressMeasures &spm,
+        MaxMeasureLiftingStrategy2::Metric metric );
+    ~BucketMaxMeasureLiftingStrategy2();
+
+    void push(verti v);
+    void bump(verti v);
+    verti pop();
+
+protected:
+    /*! Returns the bucket that vertex `v` belongs in, based on its current
+        successor. Buckets with higher indices are extracted first. */
+    verti bucket(verti v) const;
+
+    /*! Appends vertex `v` to bucket `b`. */
+    void insert(verti v, verti b);
+
+    /*! Removes vertex `v` from its current bucket. */
+    void remove(verti v);
+
+private:
+    BucketMaxMeasureLiftingStrategy2(const BucketMaxMeasureLiftingStrategy2 &);
+    BucketMaxMeasureLiftingStrategy2 &operator=(
+        const BucketMaxMeasureLiftingStrategy2 &);
+
+private:
+    const SmallProgressMeasures &spm_;  //!< SPM instance being solved
+    const MaxMeasureLiftingStrategy2::Metric metric_;  //!< comparison metric
+
+    int digits_;                //!< number of vector components used as key
+    std::vector<verti> radix_;  //!< bounds of the components used as key
+    verti top_bucket_;          //!< index of the bucket for top successors
+
+    verti * const bucket_;      //!< for each vertex: its bucket or NO_VERTEX
+    verti * const prev_;        //!< for each vertex: previous in its bucket
+    verti * const next_;        //!< for each vertex: next in its bucket
+    std::vector<verti> head_;   //!< for each bucket: first vertex or NO_VERTEX
+    std::vector<verti> tail_;   //!< for each bucket: last vertex or NO_VERTEX
+
+    std::vector<compat_uint64_t> used_;     //!< bitmap of non-empty buckets
+    std::vector<compat_uint64_t> summary_;  //!< bitmap of non-zero used_ words
+    verti summary_top_;         //!< upper bound on highest non-zero summary_
+};
+
 /*! \ingroup LiftingStrategies
     A factory class for MaxMeasureLiftingStrategy instances. */
 class MaxMeasureLiftingStrategyFactory : public LiftingStrategyFactory
@@ -18,15 +18,14 @@
 #include <utility>
 #include <vector>
 #include <deque>
+#include <iterator>
 
 //! Returns a list of indices at which `incl` is zero.
 static std::vector<verti> collect_complement(const DenseSet<verti> &incl)
 {
     std::vector<verti> res;
-    for (verti v = incl.range_begin; v != incl.range_end; ++v)
-    {
-        if (!incl.count(v)) res.push_back(v);
-    }
+    res.reserve(incl.range_end - incl.range_begin - incl.size());
+    incl.copy_complement(std::back_inserter(res));
     return res;
 }
 
@@ -37,9 +36,6 @@ MpiRecursiveSolver::MpiRecursiveSolver( const ParityGame &game,
     // Ensure mpi_rank and mpi_size have been initialized:
     assert(mpi_size > 0 && mpi_rank >= 0 && mpi_rank < mpi_size);
 
-    // Sanity check: we assume vertex indices are unsigned integers:
-    assert(sizeof(int) == sizeof(verti));
-
     vpart_->ref();
 }
 
@@ -77,9 +73,7 @@ ParityGame::Strategy MpiRecursiveSolver::solve()
             int i = (*vpart_)(v);
             if (i != mpi_rank)
             {
-                int val = -1;
-                MPI::COMM_WORLD.Recv(&val, 1, MPI_INT, i, 0);
-                result[v] = (verti)val;
+                MPI::COMM_WORLD.Recv(&result[v], 1, MPI_VERTI, i, 0);
             }
         }
     }
@@ -89,8 +83,7 @@ ParityGame::Strategy MpiRecursiveSolver::solve()
         {
             if ((*vpart_)(v) == mpi_rank)
             {
-                int val = result[v];
-                MPI::COMM_WORLD.Send(&val, 1, MPI_INT, 0, 0);
+                MPI::COMM_WORLD.Send(&result[v], 1, MPI_VERTI, 0, 0);
             }
         }
         result.clear();
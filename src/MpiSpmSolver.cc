@@ -107,7 +107,7 @@ void MpiSpmSolver::set_vector_space(SmallProgressMeasures &spm)
     }
     std::vector<verti> global(spm.len());
     MPI::COMM_WORLD.Allreduce( &local[0], &global[0], spm.len(),
-                               MPI_INT, MPI_SUM );
+                               MPI_VERTI, MPI_SUM );
     spm.set_M(&global[0]);
 }
 
@@ -143,14 +143,13 @@ void MpiSpmSolver::update( SmallProgressMeasures &spm,
 
 void MpiSpmSolver::solve_all(SmallProgressMeasures &spm)
 {
-    assert(sizeof(int) == sizeof(verti));
     assert(&spm.game() == &part_.game());
 
     const StaticGraph &global_graph = game_.graph();
     std::vector<verti> data_in(1 + spm.len());
     std::vector<verti> data_out(1 + spm.len());
 
-    MpiTermination term((int)data_in.size(), MPI_INT, &data_in[0]);
+    MpiTermination term((int)data_in.size(), MPI_VERTI, &data_in[0]);
     std::auto_ptr<LiftingStrategy> ls(
         new InternalLiftingStrategy(part_, lsf_->create(spm.game(), spm)));
 
@@ -275,7 +274,7 @@ ParityGame::Strategy MpiSpmSolver::combine_strategies(
             }
             else
             {
-                MPI::COMM_WORLD.Recv(&result[v], 1, MPI_INT, p, 0);
+                MPI::COMM_WORLD.Recv(&result[v], 1, MPI_VERTI, p, 0);
             }
         }
     }
@@ -290,7 +289,7 @@ ParityGame::Strategy MpiSpmSolver::combine_strategies(
                 {
                     verti out = local_strategy[w];
                     if (out != NO_VERTEX) out = part_.global(out);
-                    MPI::COMM_WORLD.Send(&out, 1, MPI_INT, 0, 0);
+                    MPI::COMM_WORLD.Send(&out, 1, MPI_VERTI, 0, 0);
                 }
             }
         }
@@ -17,8 +17,16 @@
     MpiAttractorAlgorithm classes.
 */
 
+#include "Graph.h"
 #include <mpi.h>
 
+/*! MPI data type corresponding to verti (and edgei). */
+#ifdef WITH_64BIT_INDICES
+#define MPI_VERTI MPI_UNSIGNED_LONG_LONG
+#else
+#define MPI_VERTI MPI_UNSIGNED
+#endif
+
 /*! MPI process rank. */
 extern int mpi_rank;
 
@@ -38,7 +38,8 @@ public:
 
 protected:
     std::vector<verti> vec(verti v) {
-        return std::vector<verti>(spm_.vec(v), spm_.vec(v) + spm_.len(v));
+        const verti *vec_v = spm_.vec(v);  // may be a temporary buffer
+        return std::vector<verti>(vec_v, vec_v + spm_.len(v));
     }
 
 private:
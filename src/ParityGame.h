@@ -11,6 +11,7 @@
 #define PARITY_GAME_H_INCLUDED
 
 #include "Graph.h"
+#include <stdio.h>
 #include <iostream>
 #include <vector>
 
@@ -205,7 +206,20 @@ public:
     //!\name Input/Output
     //!@{
 
-    /*! Read a game description in PGSolver format. */
+    /*! Read a game description in PGSolver format from memory. The text is
+        split into line-aligned chunks which are parsed concurrently (when
+        compiled with thread support), and the graph is constructed directly
+        from the parsed successor lists. If the input is invalid, an error is
+        reported and the game is left empty. */
+    void read_pgsolver( const char *begin, const char *end,
+        StaticGraph::EdgeDirection edge_dir = StaticGraph::EDGE_BIDIRECTIONAL );
+
+    /*! Read a game description in PGSolver format from a file, which is mapped
+        into memory if possible, or read completely otherwise. */
+    void read_pgsolver( FILE *fp,
+        StaticGraph::EdgeDirection edge_dir = StaticGraph::EDGE_BIDIRECTIONAL );
+
+    /*! Read a game description in PGSolver format from an input stream. */
     void read_pgsolver( std::istream &is,
         StaticGraph::EdgeDirection edge_dir = StaticGraph::EDGE_BIDIRECTIONAL );
 
@@ -220,6 +234,11 @@ public:
     /*! Read raw parity game data from input stream */
     void read_raw(std::istream &is);
 
+    /*! Read raw parity game data from the file at `path`, mapping the graph's
+        edge arrays into memory instead of copying them.
+        \see StaticGraph::map_raw() */
+    void map_raw(const char *path);
+
     /*! Write raw parity game data to output stream */
     void write_raw(std::ostream &os) const;
 
@@ -7,9 +7,29 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#if defined(__unix__) || defined(__linux__)
+#define POSIX
+#endif
+
 #include "ParityGame.h"
 #include "Logger.h"
 #include <assert.h>
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#ifdef POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
 
 #ifdef WITH_MCRL2
 #include <mcrl2/data/rewrite_strategy.h>
@@ -22,131 +42,327 @@
    considers higher values to dominate lower values, while I assume the opposite
    (i.e. 0 is the `highest` priority) throughout the rest of the code. */
 
-void ParityGame::read_pgsolver( std::istream &is,
-                                StaticGraph::EdgeDirection edge_dir )
-{
-    int max_prio = 0;
-    std::vector<ParityGameVertex> vertices;
-    StaticGraph::edge_list edges;
+namespace {
 
-    // Read "parity" header line (if present)
-    char ch = 0;
-    while (!isalnum(ch)) is.get(ch);
-    is.putback(ch);
-    if (!isdigit(ch))
-    {
-        std::string parity;
-        verti max_vertex;
-
-        if (!(is >> parity >> max_vertex)) return;
-        if (parity != "parity") return;
-        vertices.reserve(max_vertex + 1);
+/*! Vertex specifications parsed from a part of a PGSolver file. */
+struct PGSolverChunk
+{
+    std::vector<verti>              ids;        //!< indices of vertices
+    std::vector<ParityGameVertex>   vertices;   //!< vertex players/priorities
+    std::vector<size_t>             ends;       //!< ends of successor lists
+    std::vector<verti>              succs;      //!< all successor lists
+    verti                           size;       //!< max. vertex index + 1
+    int                             max_prio;   //!< max. priority read
+    const char                      *error;     //!< syntax error (or NULL)
+};
+
+}  // namespace
+
+static inline const char *skip_space(const char *p, const char *end)
+{
+    while (p != end && isspace((unsigned char)*p)) ++p;
+    return p;
+}
 
-        // Skip to terminating semicolon
-        while (is.get(ch) && ch != ';') ch = 0;
-    }
+/*! Parses an unsigned decimal integer at `p` into `value`, and returns a
+    pointer past its last digit, or NULL if no valid integer was found. */
+static inline const char *parse_uint( const char *p, const char *end,
+                                      verti &value )
+{
+    if (p == end || *p < '0' || *p > '9') return NULL;
+    verti res = 0;
+    do {
+        verti digit = *p++ - '0';
+        if (res > (NO_VERTEX - 1 - digit)/10) return NULL;
+        res = 10*res + digit;
+    } while (p != end && *p >= '0' && *p <= '9');
+    value = res;
+    return p;
+}
 
-    // Read and discard "start" line (if present)
-    while (!isalnum(ch)) is.get(ch);
-    is.putback(ch);
-    if (!isdigit(ch))
+/*! Returns the start of the first line after `p` that follows a line ending
+    with a semicolon, which is where the next vertex specification starts. */
+static const char *next_spec(const char *begin, const char *p, const char *end)
+{
+    while ((p = (const char*)memchr(p, '\n', end - p)) != NULL)
     {
-        std::string start;
-        verti vertex;
-
-        if (!(is >> start >> vertex)) return;
-        if (start != "start") return;
-
-        // Skip to terminating semicolon
-        while (is.get(ch) && ch != ';') ch = 0;
+        const char *q = p++;
+        while (q > begin && (q[-1] == ' ' || q[-1] == '\t' || q[-1] == '\r'))
+        {
+            --q;
+        }
+        if (q > begin && q[-1] == ';') return p;
     }
+    return end;
+}
 
-    // Invalid vertex (used to mark uninitialized vertices)
-    ParityGameVertex invalid = { (unsigned char)-1, (unsigned char)-1 };
+/*! Returns the line number of position `p` in the text starting at `begin`. */
+static long line_number(const char *begin, const char *p)
+{
+    return 1 + std::count(begin, p, '\n');
+}
 
-    // Read vertex specs
-    while (is)
+/*! Parses the vertex specifications in [begin:end) into `chunk`. */
+static void parse_pgsolver_chunk( const char *begin, const char *end,
+                                  PGSolverChunk &chunk )
+{
+    chunk.size     = 0;
+    chunk.max_prio = 0;
+    chunk.error    = NULL;
+    for (const char *p = skip_space(begin, end); p != end; p = skip_space(p, end))
     {
-        verti id;
-        int prio, player;
-        if (!(is >> id >> prio >> player)) break;
-
-        assert(prio >= 0);
-        assert(prio < 65536);
-        assert(player == 0 || player == 1);
-        if (prio > max_prio) max_prio = prio;
-        if (id >= vertices.size()) vertices.resize(id + 1, invalid);
-
-        /* FIXME: the PGSolver file format description allows vertices to be
-                  defined more than once (in that case, the old vertex should
-                  be removed), but we currently don't support that. Instead,
-                  just assert that each vertex is initialized once. */
-        assert(vertices[id] == invalid);
-
-        vertices[id].player   = player;
-        vertices[id].priority = prio;
+        const char *spec = p;
+        verti id, prio, player, succ;
+        if ( !(p = parse_uint(p, end, id)) ||
+             !(p = parse_uint(skip_space(p, end), end, prio)) ||
+             !(p = parse_uint(skip_space(p, end), end, player)) ||
+             !(p = parse_uint(skip_space(p, end), end, succ)) ||
+             prio >= 65536 || player > 1 )
+        {
+            chunk.error = spec;
+            return;
+        }
+        if (id >= chunk.size) chunk.size = id + 1;
+        if ((int)prio > chunk.max_prio) chunk.max_prio = prio;
 
         // Read successors
-        do {
-            verti succ;
-            if (!(is >> succ)) break;
-            if (succ >= vertices.size()) vertices.resize(succ + 1, invalid);
-
-            edges.push_back(std::make_pair(id, succ));
+        for (;;)
+        {
+            chunk.succs.push_back(succ);
+            if (succ >= chunk.size) chunk.size = succ + 1;
 
             // Skip to separator (comma) or end-of-list (semicolon), while
             // ignoring the contents of quoted strings.
             bool quoted = false, escaped = false;
-            while (is.get(ch)) {
+            char sep = 0;
+            while (p != end)
+            {
+                char ch = *p++;
                 if (ch == '"' && !escaped) quoted = !quoted;
                 escaped = ch == '\\' && !escaped;
-                if ((ch == ',' || ch == ';') && !quoted) break;
+                if ((ch == ',' || ch == ';') && !quoted)
+                {
+                    sep = ch;
+                    break;
+                }
+            }
+            if (sep != ',') break;
+            if (!(p = parse_uint(skip_space(p, end), end, succ)))
+            {
+                chunk.error = spec;
+                return;
             }
+        }
+
+        ParityGameVertex vertex = { (unsigned char)player,
+                                    (compat_uint16_t)prio };
+        chunk.ids.push_back(id);
+        chunk.vertices.push_back(vertex);
+        chunk.ends.push_back(chunk.succs.size());
+    }
+}
 
-        } while (is && ch == ',');
+void ParityGame::read_pgsolver( const char *begin, const char *end,
+                                StaticGraph::EdgeDirection edge_dir )
+{
+    clear();
+
+    // Skip "parity" and "start" header lines (if present)
+    const char *p = skip_space(begin, end);
+    while (p != end && isalpha((unsigned char)*p))
+    {
+        const char *word = p;
+        while (p != end && isalpha((unsigned char)*p)) ++p;
+        std::string keyword(word, p);
+        verti value;
+        if ( (keyword != "parity" && keyword != "start") ||
+             !parse_uint(skip_space(p, end), end, value) ||
+             !(p = (const char*)memchr(p, ';', end - p)) )
+        {
+            Logger::error( "Invalid header in PGSolver input on line %ld!",
+                           line_number(begin, word) );
+            return;
+        }
+        p = skip_space(p + 1, end);
     }
 
+    // Split remaining input into line-aligned chunks, and parse these:
+    int num_chunks = 1;
+#ifdef WITH_THREADS
+    if (end - p > 1048576) num_chunks = 4*omp_get_max_threads();
+#endif
+    std::vector<const char*> bounds(num_chunks + 1, end);
+    bounds[0] = p;
+    for (int i = 1; i < num_chunks; ++i)
+    {
+        const char *q = p + (end - p)/num_chunks*i;
+        bounds[i] = std::max(bounds[i - 1], next_spec(begin, q, end));
+    }
+    std::vector<PGSolverChunk> chunks(num_chunks);
+#ifdef WITH_THREADS
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < num_chunks; ++i)
+    {
+        parse_pgsolver_chunk(bounds[i], bounds[i + 1], chunks[i]);
+    }
+
+    verti size = 0;
+    int max_prio = 0;
+    size_t num_edges = 0;
+    for (int i = 0; i < num_chunks; ++i)
+    {
+        if (chunks[i].error)
+        {
+            Logger::error( "Syntax error in PGSolver input on line %ld!",
+                           line_number(begin, chunks[i].error) );
+            return;
+        }
+        size      = std::max(size, chunks[i].size);
+        max_prio  = std::max(max_prio, chunks[i].max_prio);
+        num_edges += chunks[i].succs.size();
+    }
+    const edgei E = (edgei)num_edges;
+    if (E != num_edges) Logger::fatal("Too many edges in PGSolver input!");
+
     // Ensure max_prio is even, so max_prio - p preserves parity:
     if (max_prio%2 == 1) ++max_prio;
 
+    // Collect vertex specs (marking unused vertices with an invalid player)
+    ParityGameVertex invalid = { (unsigned char)-1, 0 };
+    std::vector<ParityGameVertex> vertices(size, invalid);
+    for (int i = 0; i < num_chunks; ++i)
+    {
+        const PGSolverChunk &chunk = chunks[i];
+        for (size_t j = 0; j < chunk.ids.size(); ++j)
+        {
+            /* FIXME: the PGSolver file format description allows vertices to
+                      be defined more than once (in that case, the old vertex
+                      should be removed), but we currently don't support that. */
+            if (vertices[chunk.ids[j]].player != invalid.player)
+            {
+                Logger::error( "Vertex %ld defined more than once in PGSolver "
+                               "input!", (long)chunk.ids[j] );
+                return;
+            }
+            vertices[chunk.ids[j]] = chunk.vertices[j];
+        }
+    }
+
     // Look for unused vertex indices:
-    std::vector<verti> vertex_map(vertices.size(), NO_VERTEX);
-    verti used = 0;
-    for (verti v = 0; v < (verti)vertices.size(); ++v)
+    std::vector<verti> vertex_map(size, NO_VERTEX);
+    verti V = 0;
+    for (verti v = 0; v < size; ++v)
     {
-        if (vertices[v] != invalid) {
-            vertices[used] = vertices[v];
-            vertex_map[v] = used++;
+        if (vertices[v].player != invalid.player)
+        {
+            vertices[V] = vertices[v];
+            vertex_map[v] = V++;
         }
     }
-    if (used < (verti)vertices.size())
+
+    // Compute successor index directly from the successor counts:
+    edgei *successor_index = new edgei[V + 1]();
+    for (int i = 0; i < num_chunks; ++i)
     {
-        // Remove unused vertices:
-        vertices.erase(vertices.begin() + used, vertices.end());
+        const PGSolverChunk &chunk = chunks[i];
+        for (size_t j = 0; j < chunk.ids.size(); ++j)
+        {
+            successor_index[vertex_map[chunk.ids[j]] + 1] =
+                chunk.ends[j] - (j > 0 ? chunk.ends[j - 1] : 0);
+        }
+    }
+    for (verti v = 0; v < V; ++v)
+    {
+        successor_index[v + 1] += successor_index[v];
+    }
 
-        // Remap edges to new vertex indices:
-        for ( StaticGraph::edge_list::iterator it = edges.begin();
-              it != edges.end(); ++it )
+    // Copy (renumbered and sorted) successor lists into place:
+    verti *successors = new verti[E];
+    bool valid = true;
+#ifdef WITH_THREADS
+    #pragma omp parallel for schedule(dynamic) reduction(&&:valid)
+#endif
+    for (int i = 0; i < num_chunks; ++i)
+    {
+        const PGSolverChunk &chunk = chunks[i];
+        for (size_t j = 0; j < chunk.ids.size(); ++j)
         {
-            it->first  = vertex_map[it->first];
-            it->second = vertex_map[it->second];
-            assert(it->first != NO_VERTEX && it->second != NO_VERTEX);
+            verti *dst = &successors[successor_index[vertex_map[chunk.ids[j]]]];
+            verti *it = dst;
+            for (size_t k = j > 0 ? chunk.ends[j - 1] : 0; k < chunk.ends[j]; ++k)
+            {
+                *it = vertex_map[chunk.succs[k]];
+                if (*it++ == NO_VERTEX) valid = false;
+            }
+            if (!is_sorted(dst, it, std::less<verti>())) std::sort(dst, it);
         }
     }
+    chunks.clear();
+    if (!valid)
+    {
+        Logger::error("Undefined successor vertex in PGSolver input!");
+        delete[] successors;
+        delete[] successor_index;
+        return;
+    }
 
     // Assign vertex info and recount cardinalities
-    reset((verti)vertices.size(), max_prio + 1);
-    for (size_t n = 0; n < vertices.size(); ++n)
+    reset(V, max_prio + 1);
+    for (verti v = 0; v < V; ++v)
     {
-        assert(vertices[n] != invalid);
-        vertex_[n].player   = vertices[n].player;
-        vertex_[n].priority = max_prio - vertices[n].priority;
+        vertex_[v].player   = vertices[v].player;
+        vertex_[v].priority = max_prio - vertices[v].priority;
     }
-    recalculate_cardinalities(vertices.size());
-    vertices.clear();
+    recalculate_cardinalities(V);
 
     // Assign graph
-    graph_.assign(edges, edge_dir);
+    graph_.assign(V, E, successors, successor_index, edge_dir);
+}
+
+void ParityGame::read_pgsolver( FILE *fp,
+                                StaticGraph::EdgeDirection edge_dir )
+{
+#ifdef POSIX
+    // Map regular files into memory, to avoid copying the input:
+    struct stat st;
+    int fd = fileno(fp);
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if ( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+         offset == 0 && st.st_size > 0 )
+    {
+        size_t size = st.st_size;
+        void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            madvise(data, size, MADV_SEQUENTIAL);
+            read_pgsolver((const char*)data, (const char*)data + size, edge_dir);
+            munmap(data, size);
+            return;
+        }
+    }
+#endif
+
+    // Otherwise, read all input using large blocks:
+    std::vector<char> data;
+    size_t size = 0;
+    for (;;)
+    {
+        data.resize(std::max(size + 1048576, 2*size));
+        size_t read = fread(&data[size], 1, data.size() - size, fp);
+        if (read == 0) break;
+        size += read;
+    }
+    read_pgsolver(&data[0], &data[0] + size, edge_dir);
+}
+
+void ParityGame::read_pgsolver( std::istream &is,
+                                StaticGraph::EdgeDirection edge_dir )
+{
+    std::vector<char> data( (std::istreambuf_iterator<char>(is)),
+                            std::istreambuf_iterator<char>() );
+    read_pgsolver(data.empty() ? NULL : &data[0],
+                  data.empty() ? NULL : &data[0] + data.size(), edge_dir);
 }
 
 void ParityGame::write_pgsolver(std::ostream &os) const
@@ -255,6 +471,18 @@ void ParityGame::read_raw(std::istream &is)
     is.read((char*)cardinality_, sizeof(verti)*d);
 }
 
+void ParityGame::map_raw(const char *path)
+{
+    std::ifstream ifs(path, std::ios::in | std::ios::binary);
+    ifs.seekg(graph_.map_raw(path));
+    int d;
+    ifs.read((char*)&d, sizeof(d));
+    reset(graph_.V(), d);
+    ifs.read((char*)vertex_, sizeof(ParityGameVertex)*graph_.V());
+    ifs.read((char*)cardinality_, sizeof(verti)*d);
+    if (!ifs) Logger::fatal("Could not read parity game data from \"%s\"!", path);
+}
+
 void ParityGame::write_raw(std::ostream &os) const
 {
     graph_.write_raw(os);
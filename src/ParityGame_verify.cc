@@ -8,8 +8,11 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include "ParityGame.h"
+#include "CompressedGraph.h"
 #include "SCC.h"
 #include <assert.h>
+#include <utility>
+#include <vector>
 
 /*! \file ParityGame_verify.cc
 
@@ -25,10 +28,11 @@
 
     \see ParityGame::verify
 */
+template<class GraphT>
 struct VerifySCC  // used by ParityGame::verify()
 {
     const ParityGame    &game;
-    const StaticGraph   &graph;
+    const GraphT        &graph;
     const int           prio;
     verti * const       error;
 
@@ -52,6 +56,65 @@ struct VerifySCC  // used by ParityGame::verify()
     }
 };
 
+/*! Provides the successor lists of the subgraph that ParityGame::verify()
+    searches for cycles through vertices with priority `prio`: edges between
+    vertices with priorities >= `prio` won by player (1 - prio%2), which are
+    consistent with the strategy. The lists are computed on the fly, so they
+    can be passed to CompressedGraph::assign_successors().
+
+    \see ParityGame::verify
+*/
+class VerifySubgraphLists  // used by ParityGame::verify()
+{
+public:
+    VerifySubgraphLists( const ParityGame &game,
+                         const ParityGame::Strategy &strategy, int prio )
+        : game_(game), strategy_(strategy), prio_(prio) { }
+
+    std::pair<const verti*, const verti*> range(verti v)
+    {
+        const StaticGraph &graph = game_.graph();
+        buf_.clear();
+        if ( game_.priority(v) >= prio_ &&
+             (int)game_.winner(strategy_, v) == (1 - prio_%2) )
+        {
+            if (strategy_[v] != NO_VERTEX)
+            {
+                if (game_.priority(strategy_[v]) >= prio_)
+                {
+                    buf_.push_back(strategy_[v]);
+                }
+            }
+            else
+            {
+                for (StaticGraph::const_iterator it = graph.succ_begin(v);
+                     it != graph.succ_end(v); ++it)
+                {
+                    if (game_.priority(*it) >= prio_) buf_.push_back(*it);
+                }
+            }
+        }
+        const verti *begin = buf_.empty() ? NULL : &buf_[0];
+        return std::make_pair(begin, begin + buf_.size());
+    }
+
+private:
+    const ParityGame            &game_;
+    const ParityGame::Strategy  &strategy_;
+    const int                   prio_;
+    std::vector<verti>          buf_;       //!< successors of last vertex
+};
+
+/*! Returns whether `graph` contains a cycle through a vertex with priority
+    `prio`, and if so, stores such a vertex in `*error` (if it is not NULL).*/
+template<class GraphT>
+static bool find_cycle( const ParityGame &game, const GraphT &graph,
+                        int prio, verti *error )
+{
+    VerifySCC<GraphT> verifier = { game, graph, prio, error };
+    return decompose_graph(graph, verifier) != 0;
+}
+
 bool ParityGame::verify(const Strategy &s, verti *error) const
 {
     assert(s.size() == graph_.V());
@@ -103,30 +166,13 @@ bool ParityGame::verify(const Strategy &s, verti *error) const
         /* Create set of edges incident with vertices in the winning set of
            player (1 - prio%2) consistent with strategy s and incident with
            vertices of priorities >= prio only. */
-        StaticGraph::edge_list edges;
-        for (verti v = 0; v < graph_.V(); ++v)
+        const verti V = graph_.V();
+        VerifySubgraphLists lists(*this, s, prio);
+        edgei E = 0;
+        for (verti v = 0; v < V; ++v)
         {
-            if (priority(v) >= prio && (int)winner(s, v) == (1 - prio%2))
-            {
-                if (s[v] != NO_VERTEX)
-                {
-                    if (priority(s[v]) >= prio)
-                    {
-                        edges.push_back(std::make_pair(v, s[v]));
-                    }
-                }
-                else
-                {
-                    for (StaticGraph::const_iterator it = graph_.succ_begin(v);
-                         it != graph_.succ_end(v); ++it)
-                    {
-                        if (priority(*it) >= prio)
-                        {
-                            edges.push_back(std::make_pair(v, *it));
-                        }
-                    }
-                }
-            }
+            std::pair<const verti*, const verti*> r = lists.range(v);
+            E += (edgei)(r.second - r.first);
         }
 
         /* NOTE: we should NOT compact vertices here, because then we cannot
@@ -139,16 +185,31 @@ bool ParityGame::verify(const Strategy &s, verti *error) const
            edges, which require sorting).
         */
 
-        // Create a subgraph storing successors only:
-        StaticGraph subgraph;
-        subgraph.assign(edges, StaticGraph::EDGE_SUCCESSOR);
-
-        // Find a vertex with priority prio on a cycle:
-        VerifySCC verifier = { *this, subgraph, prio, error };
-        if (decompose_graph(subgraph, verifier) != 0)
+        /* Create a subgraph storing successors only and find a vertex with
+           priority prio on a cycle. VerifySCC sets *error if one is found.
+           If the subgraph would not fit in memory otherwise, it is encoded
+           in compressed form directly, without collecting an edge list. */
+        if (CompressedGraph::preferred(V, E, StaticGraph::EDGE_SUCCESSOR))
+        {
+            CompressedGraph subgraph;
+            subgraph.assign_successors(V, E, lists);
+            if (find_cycle(*this, subgraph, prio, error)) return false;
+        }
+        else
         {
-            // VerifySCC has already set *error here.
-            return false;
+            StaticGraph::edge_list edges;
+            edges.reserve(E);
+            for (verti v = 0; v < V; ++v)
+            {
+                std::pair<const verti*, const verti*> r = lists.range(v);
+                for ( ; r.first != r.second; ++r.first)
+                {
+                    edges.push_back(std::make_pair(v, *r.first));
+                }
+            }
+            StaticGraph subgraph;
+            subgraph.assign(edges, StaticGraph::EDGE_SUCCESSOR, V);
+            if (find_cycle(*this, subgraph, prio, error)) return false;
         }
     }
     if (error) *error = NO_VERTEX;
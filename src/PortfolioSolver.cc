@@ -0,0 +1,91 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "PortfolioSolver.h"
+#include <memory>
+#include <omp.h>
+
+PortfolioSolver::PortfolioSolver(
+    const ParityGame &game,
+    const std::vector<ParityGameSolverFactory*> &factories,
+    const verti *vmap, verti vmap_size )
+    : ParityGameSolver(game), factories_(factories),
+      vmap_(vmap), vmap_size_(vmap_size), winner_(-1)
+{
+    for (size_t i = 0; i < factories_.size(); ++i) factories_[i]->ref();
+}
+
+PortfolioSolver::~PortfolioSolver()
+{
+    for (size_t i = 0; i < factories_.size(); ++i) factories_[i]->deref();
+}
+
+ParityGame::Strategy PortfolioSolver::solve()
+{
+    const int n = (int)factories_.size();
+    ParityGame::Strategy result;
+    winner_ = -1;
+
+    // Abort flags of the subsolvers; all but the winner's are set as soon as
+    // a solution has been found.
+    volatile bool *cancelled = new volatile bool[n];
+    for (int i = 0; i < n; ++i) cancelled[i] = false;
+
+    info("(PortfolioSolver) Running %d solvers concurrently...", n);
+    #pragma omp parallel num_threads(n)
+    {
+        // If fewer threads are available than requested, a thread runs
+        // multiple solvers in turn (skipping those cancelled meanwhile).
+        for (int i = omp_get_thread_num(); i < n; i += omp_get_num_threads())
+        {
+            if (cancelled[i]) continue;
+
+            /* Solvers and their factories are reference counted, so creating
+               and destroying them must be serialized. */
+            Abortable::Scope scope(&cancelled[i]);
+            std::auto_ptr<ParityGameSolver> solver;
+            #pragma omp critical(PortfolioSolver)
+            solver.reset(factories_[i]->create(game_, vmap_, vmap_size_));
+            ParityGame::Strategy strategy = solver->solve();
+            #pragma omp critical(PortfolioSolver)
+            {
+                solver.reset();
+                if (!strategy.empty() && winner_ < 0)
+                {
+                    info("(PortfolioSolver) Solver %d finished first.", i);
+                    winner_ = i;
+                    result.swap(strategy);
+                    for (int j = 0; j < n; ++j) cancelled[j] = (j != i);
+                }
+            }
+        }
+    }
+    delete[] cancelled;
+
+    return result;
+}
+
+PortfolioSolverFactory::PortfolioSolverFactory(
+    const std::vector<ParityGameSolverFactory*> &factories )
+    : factories_(factories)
+{
+    for (size_t i = 0; i < factories_.size(); ++i) factories_[i]->ref();
+}
+
+PortfolioSolverFactory::~PortfolioSolverFactory()
+{
+    for (size_t i = 0; i < factories_.size(); ++i) factories_[i]->deref();
+}
+
+ParityGameSolver *PortfolioSolverFactory::create( const ParityGame &game,
+        const verti *vertex_map, verti vertex_map_size )
+{
+    return new PortfolioSolver( game, factories_,
+                                vertex_map, vertex_map_size );
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PORTFOLIO_SOLVER_H_INCLUDED
+#define PORTFOLIO_SOLVER_H_INCLUDED
+
+#include "ParityGameSolver.h"
+#include "Logger.h"
+#include <vector>
+
+/*! A solver that runs several solvers concurrently on the same game, and
+    returns the strategy computed by the first one to finish successfully.
+
+    Each subsolver runs in its own thread, and is constructed inside an
+    Abortable::Scope with a private abort flag, so the remaining subsolvers
+    (including any subsolvers they created themselves) can be cancelled
+    individually as soon as a solution has been found.
+
+    Subsolvers run single-threaded (nested parallel regions are serialized)
+    and share the game read-only, so they must not modify it.
+*/
+class PortfolioSolver : public ParityGameSolver, public virtual Logger
+{
+public:
+    /*! Constructs a solver for `game` that races solvers created by each of
+        the given factories, which are referenced for the lifetime of the
+        solver. */
+    PortfolioSolver( const ParityGame &game,
+                     const std::vector<ParityGameSolverFactory*> &factories,
+                     const verti *vmap = 0, verti vmap_size = 0 );
+    ~PortfolioSolver();
+
+    ParityGame::Strategy solve();
+
+    /*! Returns the index of the factory whose solver produced the result of
+        the last call to solve(), or -1 if all solvers failed. */
+    int winner() const { return winner_; }
+
+private:
+    std::vector<ParityGameSolverFactory*> factories_;   //!< subsolver factories
+    const verti *vmap_;                                 //!< current vertex map
+    const verti vmap_size_;                             //!< size of vertex map
+    int winner_;                                        //!< index of winner
+};
+
+//! Factory class for PortfolioSolver instances.
+class PortfolioSolverFactory : public ParityGameSolverFactory
+{
+public:
+    //! \see PortfolioSolver::PortfolioSolver()
+    PortfolioSolverFactory(const std::vector<ParityGameSolverFactory*> &fs);
+    ~PortfolioSolverFactory();
+
+    //! Return a new PortfolioSolver instance.
+    ParityGameSolver *create( const ParityGame &game,
+        const verti *vertex_map, verti vertex_map_size );
+
+protected:
+    std::vector<ParityGameSolverFactory*> factories_;   //!< subsolver factories
+};
+
+#endif /* ndef PORTFOLIO_SOLVER_H_INCLUDED */
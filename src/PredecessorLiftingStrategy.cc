@@ -51,7 +51,7 @@ PredecessorLiftingStrategy::~PredecessorLiftingStrategy()
 
 void PredecessorLiftingStrategy::push(verti v)
 {
-    Logger::debug("push(%d)", v);
+    Logger::debug("push(%ld)", (long)v);
     queue_[queue_end_++] = v;
     if (queue_end_ == queue_capacity_) queue_end_ = 0;
     ++queue_size_;
@@ -77,7 +77,7 @@ verti PredecessorLiftingStrategy::pop()
         if (queue_begin_ == queue_capacity_) queue_begin_ = 0;
     }
     --queue_size_;
-    Logger::debug("pop() -> %d", res);
+    Logger::debug("pop() -> %ld", (long)res);
     return res;
 }
 
@@ -71,6 +71,7 @@ public:
     PredecessorLiftingStrategyFactory(bool stack = false) : stack_(stack) { };
 
     bool supports_version(int version);
+    bool stack() const { return stack_; }
     LiftingStrategy *create( const ParityGame &game,
                              const SmallProgressMeasures &spm );
     LiftingStrategy2 *create2( const ParityGame &game,
@@ -7,9 +7,9 @@
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
-#include "DenseSet.h"
 #include "RecursiveSolver.h"
 #include "attractor.h"
+#include <algorithm>
 #include <set>
 #include <assert.h>
 
@@ -19,21 +19,16 @@
     V (exclusive) where 0 <= v < V is in the result iff. it is not included in
     the set s.
 */
-static std::vector<verti> get_complement(verti V, const DenseSet<verti> &s)
+template<class SetT>
+static std::vector<verti> get_complement(verti V, const SetT &s)
 {
     std::vector<verti> res;
     verti n = V - s.size();
     res.reserve(n);
-    DenseSet<verti>::const_iterator it = s.begin(), end = s.end();
-    verti v = 0;
-    while (it != end)
+    for (verti v = 0; v < V; ++v)
     {
-        verti w = *it;
-        while (v < w) res.push_back(v++);
-        ++v;
-        ++it;
+        if (!s.count(v)) res.push_back(v);
     }
-    while (v < V) res.push_back(v++);
     assert(n == (verti)res.size());
     return res;
 }
@@ -68,20 +63,15 @@ ParityGame::Strategy RecursiveSolver::solve()
     game.assign(game_);
     ParityGame::Strategy strategy(game.graph().V(), NO_VERTEX);
     Substrategy substrat(strategy);
+    attractor_.resize(game.graph().V());
     if (!solve(game, substrat)) strategy.clear();
     return strategy;
 }
 
-/* Implementation note: the recursive solver might use either a DenseSet or
-   a std::set to store vertex sets (which are passed to make_attractor_set).
-   The former is faster when the size of these sets is large, but requires O(V)
-   time and memory to initialize, which is costly when these sets are small.
-
-   It seems that the benefit of faster lookups during attractor set computation
-   usually tips the balance in favor of the DenseSet.
-
-   Note that hash sets cannot readily be used because get_complement() expects
-   iterators to produce the set contents in-order.
+/* Implementation note: vertex sets (which are passed to make_attractor_set)
+   are stored in attractor_, which is shared by all recursive calls. Like a
+   DenseSet, it provides constant-time lookups, but it only needs to be
+   allocated once, and can be cleared in constant time.
 */
 
 bool RecursiveSolver::solve(ParityGame &game, Substrategy &strat)
@@ -100,15 +90,20 @@ bool RecursiveSolver::solve(ParityGame &game, Substrategy &strat)
         // Compute attractor set of minimum priority vertices:
         {
             ParityGame::Player player = (ParityGame::Player)((prio - 1)%2);
-            //std::set<verti> min_prio_attr;
-            DenseSet<verti> min_prio_attr(0, V);
+            AttractorContext &min_prio_attr = attractor_;
+            min_prio_attr.clear();
             for (verti v = 0; v < V; ++v)
             {
-                if (game.priority(v) < prio) min_prio_attr.insert(v);
+                if (game.priority(v) < prio)
+                {
+                    min_prio_attr.insert(v);
+                    queue_.push_back(v);
+                }
             }
             debug("|min_prio|=%d", (int)min_prio_attr.size());
             assert(!min_prio_attr.empty());
-            make_attractor_set_2(game, player, min_prio_attr, strat);
+            attractor_.make_attractor_set( game, graph, player,
+                                           min_prio_attr, queue_, strat );
             debug("|min_prio_attr|=%d", (int)min_prio_attr.size());
             if (min_prio_attr.size() == V) break;
             get_complement(V, min_prio_attr).swap(unsolved);
@@ -118,25 +113,27 @@ bool RecursiveSolver::solve(ParityGame &game, Substrategy &strat)
         {
             ParityGame subgame;
             subgame.make_subgame(game, unsolved.begin(), unsolved.end(),
-                                 true, StaticGraph::EDGE_PREDECESSOR);
+                                 true, StaticGraph::EDGE_BIDIRECTIONAL);
             Substrategy substrat(strat, unsolved);
             if (!solve(subgame, substrat)) return false;
 
             // Compute attractor set of all vertices won by the opponent:
             ParityGame::Player opponent = (ParityGame::Player)(prio%2);
-            //std::set<verti> lost_attr;
-            DenseSet<verti> lost_attr(0, V);
+            AttractorContext &lost_attr = attractor_;
+            lost_attr.clear();
             for ( std::vector<verti>::const_iterator it = unsolved.begin();
                   it != unsolved.end(); ++it )
             {
                 if (strat.winner(*it, game.player(*it)) == opponent)
                 {
                     lost_attr.insert(*it);
+                    queue_.push_back(*it);
                 }
             }
             debug("|lost|=%d", (int)lost_attr.size());
             if (lost_attr.empty()) break;
-            make_attractor_set_2(game, opponent, lost_attr, strat);
+            attractor_.make_attractor_set( game, graph, opponent,
+                                           lost_attr, queue_, strat );
             debug("|lost_attr|=%d", (int)lost_attr.size());
             get_complement(V, lost_attr).swap(unsolved);
         }
@@ -145,7 +142,7 @@ bool RecursiveSolver::solve(ParityGame &game, Substrategy &strat)
         {
             ParityGame subgame;
             subgame.make_subgame(game, unsolved.begin(), unsolved.end(),
-                                 true, StaticGraph::EDGE_PREDECESSOR);
+                                 true, StaticGraph::EDGE_BIDIRECTIONAL);
             Substrategy substrat(strat, unsolved);
             strat.swap(substrat);
             game.swap(subgame);
@@ -212,3 +209,195 @@ ParityGameSolver *RecursiveSolverFactory::create( const ParityGame &game,
 
     return new RecursiveSolver(game);
 }
+
+
+InPlaceRecursiveSolver::InPlaceRecursiveSolver(const ParityGame &game)
+    : ParityGameSolver(game), graph_(&game.graph())
+{
+}
+
+InPlaceRecursiveSolver::~InPlaceRecursiveSolver()
+{
+}
+
+ParityGame::Strategy InPlaceRecursiveSolver::solve()
+{
+    const verti V = game_.graph().V();
+
+    if (game_.graph().edge_dir() != StaticGraph::EDGE_BIDIRECTIONAL)
+    {
+        own_graph_.assign( game_.graph().get_edges(),
+                            StaticGraph::EDGE_BIDIRECTIONAL, V );
+        graph_ = &own_graph_;
+    }
+
+    vertices_.resize(V);
+    for (verti v = 0; v < V; ++v) vertices_[v] = v;
+    level_.assign(V, 0);
+    attractor_.resize(V);
+    strategy_.assign(V, NO_VERTEX);
+
+    if (!solve(0, V, 0)) strategy_.clear();
+
+    ParityGame::Strategy result;
+    result.swap(strategy_);
+    std::vector<verti>().swap(vertices_);
+    std::vector<int>().swap(level_);
+    own_graph_.clear();
+    graph_ = &game_.graph();
+    return result;
+}
+
+namespace {
+
+/*! Predicate selecting vertices with priority less than a given limit. */
+struct PriorityBelow
+{
+    PriorityBelow(const ParityGame &game, int prio)
+        : game_(game), prio_(prio) { }
+
+    bool operator()(verti v) const { return game_.priority(v) < prio_; }
+
+    const ParityGame &game_;
+    int prio_;
+};
+
+/*! Predicate selecting vertices won by a given player. */
+struct WonBy
+{
+    WonBy(const ParityGame &game, const ParityGame::Strategy &strategy,
+          ParityGame::Player player)
+        : game_(game), strategy_(strategy), player_(player) { }
+
+    bool operator()(verti v) const
+    {
+        return game_.winner(strategy_, v) == player_;
+    }
+
+    const ParityGame &game_;
+    const ParityGame::Strategy &strategy_;
+    ParityGame::Player player_;
+};
+
+/*! Predicate selecting vertices that are not included in a vertex set. */
+template<class SetT>
+struct NotIn
+{
+    NotIn(const SetT &set) : set_(set) { }
+
+    bool operator()(verti v) const { return !set_.count(v); }
+
+    const SetT &set_;
+};
+
+/*! Predicate selecting vertices in the subgame at a given recursion depth. */
+struct Alive
+{
+    Alive(const std::vector<int> &level, int depth)
+        : level_(level), depth_(depth) { }
+
+    bool operator()(verti v) const { return level_[v] >= depth_; }
+
+    const std::vector<int> &level_;
+    int depth_;
+};
+
+}  // namespace
+
+size_t InPlaceRecursiveSolver::make_attractor_set(
+    size_t begin, size_t init_end, size_t end, int depth,
+    ParityGame::Player player )
+{
+    attractor_.clear();
+    for (size_t i = begin; i < init_end; ++i)
+    {
+        attractor_.insert(vertices_[i]);
+        queue_.push_back(vertices_[i]);
+    }
+    attractor_.make_attractor_set( game_, *graph_, player, attractor_, queue_,
+                                   strategy_, Alive(level_, depth) );
+    return std::partition( vertices_.begin() + begin, vertices_.begin() + end,
+                           NotIn<AttractorContext>(attractor_) )
+           - vertices_.begin();
+}
+
+bool InPlaceRecursiveSolver::solve(size_t begin, size_t end, int depth)
+{
+    if (aborted()) return false;
+
+    std::vector<verti>::iterator first = vertices_.begin();
+    int prio;
+    for (;;)
+    {
+        // Find the first inversion in parity of priorities in the subgame:
+        int q = game_.d();
+        for (size_t i = begin; i < end; ++i)
+        {
+            q = std::min(q, game_.priority(vertices_[i]));
+        }
+        prio = game_.d();
+        for (size_t i = begin; i < end; ++i)
+        {
+            int r = game_.priority(vertices_[i]);
+            if (r%2 != q%2 && r < prio) prio = r;
+        }
+        if (prio == game_.d()) break;
+
+        debug("prio=%d", prio);
+
+        // Compute attractor set of minimum priority vertices:
+        ParityGame::Player player = (ParityGame::Player)((prio - 1)%2);
+        size_t min_prio_end = std::partition( first + begin, first + end,
+            PriorityBelow(game_, prio) ) - first;
+        debug("|min_prio|=%d", (int)(min_prio_end - begin));
+        assert(min_prio_end > begin);
+        size_t mid = make_attractor_set(begin, min_prio_end, end, depth, player);
+        debug("|min_prio_attr|=%d", (int)(end - mid));
+        if (mid == begin) break;
+
+        // Solve vertices not in the minimum priority attractor set:
+        for (size_t i = begin; i < mid; ++i) level_[vertices_[i]] = depth + 1;
+        if (!solve(begin, mid, depth + 1)) return false;
+        for (size_t i = begin; i < mid; ++i) level_[vertices_[i]] = depth;
+
+        // Compute attractor set of all vertices won by the opponent:
+        ParityGame::Player opponent = (ParityGame::Player)(prio%2);
+        size_t lost_end = std::partition( first + begin, first + mid,
+            WonBy(game_, strategy_, opponent) ) - first;
+        debug("|lost|=%d", (int)(lost_end - begin));
+        if (lost_end == begin) break;
+        mid = make_attractor_set(begin, lost_end, end, depth, opponent);
+        debug("|lost_attr|=%d", (int)(end - mid));
+
+        // Repeat with subgame of which vertices won by odd have been removed:
+        for (size_t i = mid; i < end; ++i) level_[vertices_[i]] = depth - 1;
+        end = mid;
+    }
+
+    // The opponent's winning set is empty (see RecursiveSolver::solve()):
+    const StaticGraph &graph = *graph_;
+    for (size_t i = begin; i < end; ++i)
+    {
+        const verti v = vertices_[i];
+        if (game_.priority(v) < prio)
+        {
+            strategy_[v] = NO_VERTEX;
+            if (game_.player(v) == game_.priority(v)%2)
+            {
+                StaticGraph::const_iterator it = graph.succ_begin(v);
+                while (!alive(*it, depth)) ++it;
+                strategy_[v] = *it;
+            }
+        }
+    }
+    return true;
+}
+
+ParityGameSolver *InPlaceRecursiveSolverFactory::create(
+    const ParityGame &game, const verti *vertex_map, verti vertex_map_size )
+{
+    (void)vertex_map;       // unused
+    (void)vertex_map_size;  // unused
+
+    return new InPlaceRecursiveSolver(game);
+}
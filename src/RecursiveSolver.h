@@ -12,6 +12,8 @@
 
 #include "ParityGameSolver.h"
 #include "Logger.h"
+#include "attractor.h"
+#include <deque>
 
 /*! Provides a view of a strategy corresponding to a subset of the vertex set.
     Note that elements of the substrategy can be written to, and the underlying
@@ -109,6 +111,12 @@ public:
 private:
     /*! Solves a subgame recursively, or returns false if solving is aborted. */
     bool solve(ParityGame &game, Substrategy &strat);
+
+    //! Workspace (and vertex set) for attractor computations in subgames
+    AttractorContext attractor_;
+
+    //! Queue of vertices to be processed during attractor computation
+    std::deque<verti> queue_;
 };
 
 //! Factory object for RecursiveSolver instances.
@@ -119,4 +127,74 @@ class RecursiveSolverFactory : public ParityGameSolverFactory
         const verti *vertex_map, verti vertex_map_size );
 };
 
+/*! Parity game solver implementing Zielonka's recursive algorithm without
+    constructing subgames.
+
+    All subgames are represented in-place on the original game graph: each
+    subgame is a contiguous range of a single array of vertex indices (which
+    is partitioned as the algorithm proceeds) and a vertex belongs to the
+    subgame at recursion depth `k` iff. its level is at least `k`. Attractor
+    computations skip vertices outside the current subgame, so memory use is
+    O(V) in addition to the game itself, regardless of the recursion depth.
+
+    The price is that attractor computations traverse all edges of a vertex
+    in the original game, including those to vertices that have been removed.
+    Successors in the subgame are only counted for vertices reached by an
+    attractor computation, so its cost is proportional to the size of the
+    attractor set (plus its neighbourhood) rather than the subgame. */
+class InPlaceRecursiveSolver : public ParityGameSolver, public virtual Logger
+{
+public:
+    InPlaceRecursiveSolver(const ParityGame &game);
+    ~InPlaceRecursiveSolver();
+
+    ParityGame::Strategy solve();
+
+private:
+    /*! Solves the subgame consisting of vertices `vertices_[begin:end)`,
+        which must be exactly the vertices with level `depth` or higher.
+        Returns false if solving is aborted. */
+    bool solve(size_t begin, size_t end, int depth);
+
+    /*! Returns whether vertex `v` is part of the subgame at `depth`. */
+    bool alive(verti v, int depth) const { return level_[v] >= depth; }
+
+    /*! Extends the set of vertices `vertices_[begin:init_end)` to its
+        attractor set for `player` in the subgame `vertices_[begin:end)` at
+        `depth`, then reorders the subgame so that the vertices outside the
+        attractor set come first, and returns the end of those. The attractor
+        set is left in `attractor_`. */
+    size_t make_attractor_set( size_t begin, size_t init_end, size_t end,
+                               int depth, ParityGame::Player player );
+
+    //! Bidirectional game graph (either the game's graph or own_graph_)
+    const StaticGraph *graph_;
+
+    //! Bidirectional graph constructed if the game's graph is not
+    StaticGraph own_graph_;
+
+    //! Vertex indices; subgames are contiguous ranges of this array
+    std::vector<verti> vertices_;
+
+    //! Depth of the deepest subgame each vertex belongs to
+    std::vector<int> level_;
+
+    //! Workspace (and vertex set) for attractor computations
+    AttractorContext attractor_;
+
+    //! Queue of vertices to be processed during attractor computation
+    std::deque<verti> queue_;
+
+    //! Strategy under construction
+    ParityGame::Strategy strategy_;
+};
+
+//! Factory object for InPlaceRecursiveSolver instances.
+class InPlaceRecursiveSolverFactory : public ParityGameSolverFactory
+{
+    //! Returns a new InPlaceResuriveSolver instance.
+    ParityGameSolver *create( const ParityGame &game,
+        const verti *vertex_map, verti vertex_map_size );
+};
+
 #endif /* ndef RECURSIVE_SOLVER_H_INCLUDED */
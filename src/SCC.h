@@ -17,7 +17,9 @@
 
 /*! \ingroup ParityGameData
 
-    Decomposition into strongly-connected components using Tarjan's algorithm.
+    Decomposition into strongly-connected components using Tarjan's algorithm,
+    or the parallel forward-backward algorithm for large graphs when compiled
+    with thread support (see ParallelSCC).
 
     Decomposes the static graph into strongly connected components. Components
     are found in reverse topological order (i.e. if component j is found after
@@ -28,14 +30,47 @@
     (`size_t`).  The callback should return an integer: zero to continue
     enumerating components, or non-zero to abort.
 
+    The graph may be a StaticGraph or a CompressedGraph.
+
     @return the last value returned by a call to callback
 */
 
-template<class Callback>
-int decompose_graph(const StaticGraph &graph, Callback &callback)
+template<class Callback, class GraphT>
+int decompose_graph(const GraphT &graph, Callback &callback)
+{
+#ifdef WITH_THREADS
+    if (ParallelSCC<Callback, GraphT>::preferred(graph))
+    {
+        return ParallelSCC<Callback, GraphT>(graph, callback).run();
+    }
+#endif
+    return SCC<Callback, GraphT>(graph, callback).run();
+}
+
+/*! \ingroup ParityGameData
+
+    Like decompose_graph(), but always uses the sequential algorithm, so that
+    components (and the vertices within them) are reported in an order that
+    depends only on the graph, not on the number of threads available.
+*/
+template<class Callback, class GraphT>
+int decompose_graph_sequential(const GraphT &graph, Callback &callback)
+{
+    return SCC<Callback, GraphT>(graph, callback).run();
+}
+
+#ifdef WITH_THREADS
+/*! \ingroup ParityGameData
+
+    Like decompose_graph(), but always uses the parallel algorithm, regardless
+    of the size of the graph. The graph must store both edge directions.
+*/
+template<class Callback, class GraphT>
+int decompose_graph_parallel(const GraphT &graph, Callback &callback)
 {
-    return SCC<Callback>(graph, callback).run();
+    return ParallelSCC<Callback, GraphT>(graph, callback).run();
 }
+#endif
 
 /*! \ingroup ParityGameData
 
@@ -14,6 +14,10 @@
 #include <utility>
 #include <assert.h>
 
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
+
 /*! Implements Tarjan's algorithm for finding strongly connected components in
     a directed graph.
 
@@ -27,13 +31,16 @@
     Furthermore, the lowest link index is set to NO_VERTEX if the vertex is not
     part of the current component.
 
-    Worst-case memory use: 5*sizeof(verti) + c.
+    The graph type must provide V(), succ_begin() and succ_end() like
+    StaticGraph does; successor iterators need only be forward iterators.
+
+    Worst-case memory use: 4*sizeof(verti) + sizeof(iterator) + c.
 */
-template<class Callback>
+template<class Callback, class GraphT = StaticGraph>
 class SCC
 {
 public:
-    SCC(const StaticGraph &graph, Callback &callback)
+    SCC(const GraphT &graph, Callback &callback)
         : graph_(graph), callback_(callback)
     {
     }
@@ -70,7 +77,7 @@ private:
         component.push_back(v);
 
         // Add to stack to be processed in depth-first-search
-        stack.push_back(std::make_pair(v, 0));
+        stack.push_back(std::make_pair(v, graph_.succ_begin(v)));
     }
 
     /* This implements depth-first-search using a stack, which is a bit more
@@ -84,13 +91,12 @@ private:
         while (res == 0 && !stack.empty())
         {
             verti v = stack.back().first;
-            StaticGraph::const_iterator edge_it =
-                graph_.succ_begin(v) + stack.back().second++;
+            edge_iterator &edge_it = stack.back().second;
 
             if (edge_it != graph_.succ_end(v))
             {
                 // Find next successor `w` of `v`
-                verti w = *edge_it;
+                verti w = *edge_it++;
 
                 if (info[w].first == NO_VERTEX)  // unvisited?
                 {
@@ -113,7 +119,7 @@ private:
                 {
                     /* Push my lower link index to parent vertex `u`, if it
                        is lower than the parent's current lower link index. */
-                    int u = stack.back().first;
+                    verti u = stack.back().first;
                     info[u].second = std::min(info[u].second, info[v].second);
                 }
 
@@ -140,10 +146,12 @@ private:
     }
 
 public:
-    const StaticGraph &graph_;
+    const GraphT &graph_;
     Callback &callback_;
 
 private:
+    typedef typename GraphT::const_iterator edge_iterator;
+
     //! Index of next vertex to be labelled by inorder traversal.
     verti next_index;
 
@@ -155,10 +163,429 @@ private:
 
     /*! The depth-first-search stack.
 
-        Each entry consists of a vertex index and an index into its successor
-        list.  When a new unvisited vertex `v` is discovered, a pair (`v`, 0)
-        is appened at the end of the stack.  The top element is popped off the
-        stack when its successor index points to the end of the successor list.
+        Each entry consists of a vertex index and an iterator into its
+        successor list.  When a new unvisited vertex `v` is discovered, a pair
+        (`v`, `succ_begin(v)`) is appened at the end of the stack.  The top
+        element is popped off the stack when its iterator points to the end of
+        the successor list.
     */
-    std::vector< std::pair< verti, verti > > stack;
+    std::vector< std::pair< verti, edge_iterator > > stack;
+};
+
+#ifdef WITH_THREADS
+
+/*! Finds strongly connected components in parallel, and reports them in the
+    same way (and in the same order) as the SCC class above.
+
+    Components are identified with the forward-backward algorithm: the
+    component of a pivot vertex is the intersection of the sets of vertices
+    reachable from it forward and backward, and the remaining vertices are
+    split into three partitions (forward only, backward only, and neither)
+    that contain no common components and are processed independently.
+    Reachability is computed with level-synchronous parallel breadth-first
+    search. Before that, vertices without incoming or outgoing edges within
+    their partition are trimmed off as singleton components, and partitions
+    that have become small are finished with Tarjan's algorithm, with
+    different partitions processed in parallel.
+
+    Finally, the condensed graph of components is sorted topologically, and
+    the callback is invoked for each component in reverse topological order.
+
+    The graph type must provide V(), edge_dir(), and forward iterators over
+    both successors and predecessors, like StaticGraph.
+
+    Worst-case memory use: 5*sizeof(verti) + 1 bytes per vertex, plus the
+    partitions and search frontiers.
+*/
+template<class Callback, class GraphT = StaticGraph>
+class ParallelSCC
+{
+public:
+    ParallelSCC(const GraphT &graph, Callback &callback)
+        : graph_(graph), callback_(callback)
+    {
+    }
+
+    /*! Returns whether `graph` is large enough for parallel decomposition
+        to pay off, stores edges in both directions, and multiple threads
+        are available. */
+    static bool preferred(const GraphT &graph)
+    {
+        return graph.V() >= min_parallel_vertices &&
+               graph.edge_dir() == StaticGraph::EDGE_BIDIRECTIONAL &&
+               omp_get_max_threads() > 1 && !omp_in_parallel();
+    }
+
+    int run()
+    {
+        const verti V = graph_.V();
+        comp_.assign(V, NO_VERTEX);
+        part_.assign(V, 0);
+        mark_.assign(V, 0);
+        next_part_ = 1;
+
+        std::vector<verti> all(V);
+        for (verti v = 0; v < V; ++v) all[v] = v;
+        trim(all);
+        std::vector<std::vector<verti> > large, small;
+        classify(all, large, small);
+
+        // Split large partitions with the forward-backward algorithm:
+        while (!large.empty())
+        {
+            std::vector<verti> part;
+            part.swap(large.back());
+            large.pop_back();
+            split(part, large, small);
+        }
+        std::vector<char>().swap(mark_);
+
+        // Finish small partitions with Tarjan's algorithm:
+        index_.assign(V, NO_VERTEX);
+        lowlink_.assign(V, NO_VERTEX);
+        #pragma omp parallel
+        {
+            Tarjan tarjan(*this);
+            #pragma omp for schedule(dynamic, 1)
+            for (long i = 0; i < (long)small.size(); ++i)
+            {
+                tarjan.run(small[i]);
+            }
+        }
+        std::vector<verti>().swap(index_);
+        std::vector<verti>().swap(lowlink_);
+
+        return report();
+    }
+
+private:
+    typedef typename GraphT::const_iterator edge_iterator;
+
+    //! Minimum number of vertices for which parallel decomposition is used.
+    static const verti min_parallel_vertices = 1 << 16;
+
+    //! Partitions smaller than this are processed with Tarjan's algorithm.
+    static const size_t min_split_size = 1 << 12;
+
+    //! Bits in mark_
+    enum { FORWARD = 1, BACKWARD = 2 };
+
+    /*! Returns whether `w` is not yet assigned to a component and belongs to
+        partition `p`. */
+    bool in(verti w, verti p) const
+    {
+        return __atomic_load_n(&comp_[w], __ATOMIC_RELAXED) == NO_VERTEX &&
+               part_[w] == p;
+    }
+
+    edge_iterator begin(verti v, bool forward) const
+    {
+        return forward ? graph_.succ_begin(v) : graph_.pred_begin(v);
+    }
+
+    edge_iterator end(verti v, bool forward) const
+    {
+        return forward ? graph_.succ_end(v) : graph_.pred_end(v);
+    }
+
+    /*! Returns whether `v` has an edge in the given direction to another
+        vertex in its partition. */
+    bool has_edge(verti v, bool forward) const
+    {
+        for ( edge_iterator it = begin(v, forward), e = end(v, forward);
+              it != e; ++it )
+        {
+            if (*it != v && in(*it, part_[v])) return true;
+        }
+        return false;
+    }
+
+    /*! Repeatedly removes vertices that have no incoming or outgoing edges
+        within their partition from `part`, assigning them to singleton
+        components, as long as this removes a significant fraction of the
+        partition. (Long chains are left to the other algorithms.) */
+    void trim(std::vector<verti> &part)
+    {
+        for (;;)
+        {
+            const long n = (long)part.size();
+            long removed = 0;
+            #pragma omp parallel for schedule(dynamic, 1024) \
+                                     reduction(+:removed) \
+                                     if (n >= (long)min_split_size)
+            for (long i = 0; i < n; ++i)
+            {
+                const verti v = part[i];
+                if (!has_edge(v, true) || !has_edge(v, false))
+                {
+                    __atomic_store_n(&comp_[v], v, __ATOMIC_RELAXED);
+                    ++removed;
+                }
+            }
+            if (removed == 0) break;
+            part.erase( std::remove_if( part.begin(), part.end(),
+                                        Assigned(comp_) ), part.end() );
+            if (removed < n/64) break;
+        }
+    }
+
+    /*! Predicate selecting vertices that have been assigned a component. */
+    struct Assigned
+    {
+        Assigned(const std::vector<verti> &comp) : comp_(comp) { }
+        bool operator()(verti v) const { return comp_[v] != NO_VERTEX; }
+        const std::vector<verti> &comp_;
+    };
+
+    /*! Adds `part` to `large` or `small` depending on its size, unless it
+        is empty. */
+    void classify( std::vector<verti> &part,
+                   std::vector<std::vector<verti> > &large,
+                   std::vector<std::vector<verti> > &small )
+    {
+        if (part.empty()) return;
+        std::vector<std::vector<verti> > &dest =
+            part.size() < min_split_size ? small : large;
+        dest.push_back(std::vector<verti>());
+        dest.back().swap(part);
+    }
+
+    /*! Marks all vertices reachable from `src` within its partition in the
+        given direction, by setting `bit` in mark_. */
+    void reach(verti src, bool forward, char bit)
+    {
+        const verti p = part_[src];
+        std::vector<verti> frontier(1, src), next;
+        mark_[src] |= bit;
+        while (!frontier.empty())
+        {
+            const long n = (long)frontier.size();
+            next.clear();
+            #pragma omp parallel if (n >= 64)
+            {
+                std::vector<verti> local;
+                #pragma omp for schedule(dynamic, 64) nowait
+                for (long i = 0; i < n; ++i)
+                {
+                    const verti v = frontier[i];
+                    for ( edge_iterator it = begin(v, forward),
+                                        e = end(v, forward); it != e; ++it )
+                    {
+                        const verti w = *it;
+                        if ( in(w, p) &&
+                             !(__atomic_load_n(&mark_[w], __ATOMIC_RELAXED)
+                               & bit) &&
+                             !(__atomic_fetch_or(&mark_[w], bit,
+                                                 __ATOMIC_RELAXED) & bit) )
+                        {
+                            local.push_back(w);
+                        }
+                    }
+                }
+                #pragma omp critical
+                next.insert(next.end(), local.begin(), local.end());
+            }
+            frontier.swap(next);
+        }
+    }
+
+    /*! Identifies the component of the first vertex in `part`, and splits
+        the remaining vertices into new partitions. */
+    void split( std::vector<verti> &part,
+                std::vector<std::vector<verti> > &large,
+                std::vector<std::vector<verti> > &small )
+    {
+        const verti pivot = part[0];
+        reach(pivot, true, FORWARD);
+        reach(pivot, false, BACKWARD);
+
+        // Partition ids for vertices reached forward, backward, or neither:
+        const verti ids[3] = { next_part_, next_part_ + 1, next_part_ + 2 };
+        next_part_ += 3;
+        std::vector<verti> parts[3];
+        for (size_t i = 0; i < part.size(); ++i)
+        {
+            const verti v = part[i];
+            const char m = mark_[v];
+            mark_[v] = 0;
+            if (m == (FORWARD | BACKWARD))
+            {
+                comp_[v] = pivot;
+            }
+            else
+            {
+                const int j = m == FORWARD ? 0 : m == BACKWARD ? 1 : 2;
+                part_[v] = ids[j];
+                parts[j].push_back(v);
+            }
+        }
+        std::vector<verti>().swap(part);
+        for (int j = 0; j < 3; ++j)
+        {
+            if (parts[j].size() >= min_split_size) trim(parts[j]);
+            classify(parts[j], large, small);
+        }
+    }
+
+    /*! Tarjan's algorithm restricted to a single partition (see the SCC
+        class above, from which this is adapted). Instances for different
+        partitions may run concurrently. */
+    class Tarjan
+    {
+    public:
+        Tarjan(ParallelSCC &scc) : scc_(scc) { }
+
+        void run(const std::vector<verti> &part)
+        {
+            next_index_ = 0;
+            for (size_t i = 0; i < part.size(); ++i)
+            {
+                if (scc_.index_[part[i]] == NO_VERTEX)
+                {
+                    add(part[i]);
+                    dfs(scc_.part_[part[i]]);
+                }
+            }
+        }
+
+    private:
+        void add(verti v)
+        {
+            scc_.index_[v] = scc_.lowlink_[v] = next_index_++;
+            component_.push_back(v);
+            stack_.push_back(std::make_pair(v, scc_.graph_.succ_begin(v)));
+        }
+
+        void dfs(verti p)
+        {
+            std::vector<verti> &index = scc_.index_, &lowlink = scc_.lowlink_;
+            while (!stack_.empty())
+            {
+                verti v = stack_.back().first;
+                edge_iterator &edge_it = stack_.back().second;
+
+                if (edge_it != scc_.graph_.succ_end(v))
+                {
+                    verti w = *edge_it++;
+                    if (!scc_.in(w, p)) continue;
+                    if (index[w] == NO_VERTEX)
+                    {
+                        add(w);
+                    }
+                    else
+                    if (lowlink[w] != NO_VERTEX)
+                    {
+                        lowlink[v] = std::min(lowlink[v], index[w]);
+                    }
+                }
+                else
+                {
+                    stack_.pop_back();
+                    if (!stack_.empty())
+                    {
+                        verti u = stack_.back().first;
+                        lowlink[u] = std::min(lowlink[u], lowlink[v]);
+                    }
+                    if (index[v] == lowlink[v])
+                    {
+                        std::vector<verti>::iterator it = component_.end();
+                        do {
+                            assert(it != component_.begin());
+                            lowlink[*--it] = NO_VERTEX;
+                            __atomic_store_n( &scc_.comp_[*it], v,
+                                              __ATOMIC_RELAXED );
+                        } while (*it != v);
+                        component_.erase(it, component_.end());
+                    }
+                }
+            }
+        }
+
+        ParallelSCC &scc_;
+        verti next_index_;
+        std::vector<verti> component_;
+        std::vector<std::pair<verti, edge_iterator> > stack_;
+    };
+
+    friend class Tarjan;
+
+    /*! Groups vertices by component and calls the callback for each
+        component in reverse topological order. */
+    int report()
+    {
+        const verti V = graph_.V();
+
+        // Group vertices by component (identified by a representative):
+        std::vector<verti> start(V + 1, 0), order(V);
+        for (verti v = 0; v < V; ++v) ++start[comp_[v] + 1];
+        for (verti v = 0; v < V; ++v) start[v + 1] += start[v];
+        {
+            std::vector<verti> pos(start.begin(), start.end() - 1);
+            for (verti v = 0; v < V; ++v) order[pos[comp_[v]]++] = v;
+        }
+
+        // Count edges leaving each component:
+        std::vector<verti> &outdeg = part_;
+        std::fill(outdeg.begin(), outdeg.end(), 0);
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (long i = 0; i < (long)V; ++i)
+        {
+            const verti v = (verti)i, c = comp_[v];
+            for ( edge_iterator it = graph_.succ_begin(v),
+                                e = graph_.succ_end(v); it != e; ++it )
+            {
+                if (comp_[*it] != c)
+                {
+                    __atomic_fetch_add(&outdeg[c], 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+
+        // Report components with no outgoing edges left, in queue order:
+        std::vector<verti> queue;
+        for (verti v = 0; v < V; ++v)
+        {
+            if (comp_[v] == v && outdeg[v] == 0) queue.push_back(v);
+        }
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            const verti c = queue[i];
+            int res = callback_( (const verti*)&order[start[c]],
+                                 start[c + 1] - start[c] );
+            if (res != 0) return res;
+
+            for (verti j = start[c]; j < start[c + 1]; ++j)
+            {
+                const verti v = order[j];
+                for ( edge_iterator it = graph_.pred_begin(v),
+                                    e = graph_.pred_end(v); it != e; ++it )
+                {
+                    const verti d = comp_[*it];
+                    if (d != c && --outdeg[d] == 0) queue.push_back(d);
+                }
+            }
+        }
+        return 0;
+    }
+
+private:
+    const GraphT &graph_;
+    Callback &callback_;
+
+    //! Representative vertex of each vertex's component, or NO_VERTEX
+    std::vector<verti> comp_;
+
+    //! Partition of each vertex not yet assigned to a component
+    std::vector<verti> part_;
+
+    //! Forward/backward reachability bits used by split()
+    std::vector<char> mark_;
+
+    //! Tarjan's inorder index and lowest link index of each vertex
+    std::vector<verti> index_, lowlink_;
+
+    //! Next partition id to be assigned
+    verti next_part_;
 };
+
+#endif /* def WITH_THREADS */
@@ -8,35 +8,139 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include "SmallProgressMeasures.h"
+#include "FixedDenseSPM.h"
 #include "attractor.h"
 #include "SCC.h"
+#include "Timer.h"
 #include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <sstream>
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>  /* printf() */
 
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
+
+COMPAT_THREAD_LOCAL int LiftingStatistics::thread_index_ = -1;
+int LiftingStatistics::num_thread_indices_ = 0;
+
 LiftingStatistics::LiftingStatistics( const ParityGame &game,
                                       long long max_lifts )
-    : lifts_attempted_(0), lifts_succeeded_(0), max_lifts_(max_lifts)
+    : buf_(new char[(max_threads + 1)*sizeof(Counters) + cache_line_size]),
+      max_lifts_(max_lifts)
+{
+    // Align counters to cache lines, so no two threads share one:
+    size_t misalignment = reinterpret_cast<size_t>(buf_) % cache_line_size;
+    counters_ = reinterpret_cast<Counters*>(
+        buf_ + (misalignment ? cache_line_size - misalignment : 0) );
+    for (int i = 0; i <= max_threads; ++i)
+    {
+        Counters &c = counters_[i];
+        c.attempted   = 0;
+        c.succeeded   = 0;
+        c.next_check  = max_lifts < 0 ? std::numeric_limits<long long>::max()
+                                      : std::min(max_lifts, check_interval);
+        c.next_sample = 0;
+        c.random      = 2463534242u + 69069u*i;
+    }
+    if (per_vertex()) vertex_stats_.resize(game.graph().V());
+}
+
+LiftingStatistics::~LiftingStatistics()
 {
-    vertex_stats_.resize(game.graph().V());
+    delete[] buf_;
 }
 
-void LiftingStatistics::record_lift(verti v, bool success)
+long long LiftingStatistics::lifts_attempted() const
 {
-    assert(v == NO_VERTEX || v < vertex_stats_.size());
+    long long res = 0;
+    for (int i = 0; i <= max_threads; ++i) res += counters_[i].attempted;
+    return res;
+}
+
+long long LiftingStatistics::lifts_succeeded() const
+{
+    long long res = 0;
+    for (int i = 0; i <= max_threads; ++i) res += counters_[i].succeeded;
+    return res;
+}
+
+void LiftingStatistics::add_lifts_attempted(long long count)
+{
+    Counters *c = own_counters();
+    if (c != NULL)
+    {
+        c->attempted += count;
+    }
+    else
+    {
+        Counters &shared = counters_[max_threads];
+        __atomic_fetch_add(&shared.attempted, count, __ATOMIC_RELAXED);
+    }
+}
 
-    ++lifts_attempted_;
-    if (lifts_attempted_ == max_lifts_) Abortable::abort_all();
-    if (v != NO_VERTEX) ++vertex_stats_[v].first;
-    if (success)
+void LiftingStatistics::add_lifts_succeeded(long long count)
+{
+    Counters *c = own_counters();
+    if (c != NULL)
+    {
+        c->succeeded += count;
+    }
+    else
     {
-        ++lifts_succeeded_;
-        if (v != NO_VERTEX) ++vertex_stats_[v].second;
+        Counters &shared = counters_[max_threads];
+        __atomic_fetch_add(&shared.succeeded, count, __ATOMIC_RELAXED);
     }
 }
 
+void LiftingStatistics::record_lift_shared(verti v, bool success)
+{
+    // Used by threads beyond the first max_threads only:
+    Counters &shared = counters_[max_threads];
+    long long n = __atomic_add_fetch(&shared.attempted, 1, __ATOMIC_RELAXED);
+    if (success) __atomic_fetch_add(&shared.succeeded, 1, __ATOMIC_RELAXED);
+    if (max_lifts_ >= 0 && n%check_interval == 0) check_max_lifts(shared);
+#if SPM_STATS == SPM_STATS_FULL
+    if (v != NO_VERTEX) record_vertex(v, success);
+#elif SPM_STATS == SPM_STATS_SAMPLED
+    if (v != NO_VERTEX && n%weight == 0) record_vertex(v, success);
+#else
+    (void)v;
+#endif
+}
+
+void LiftingStatistics::check_max_lifts(Counters &c)
+{
+    long long total = lifts_attempted();
+    if (total >= max_lifts_)
+    {
+        Abortable::abort_all();
+        c.next_check = std::numeric_limits<long long>::max();
+    }
+    else
+    {
+        // With a single thread, this checks again exactly at max_lifts_:
+        c.next_check = c.attempted + std::min(max_lifts_ - total,
+                                              check_interval);
+    }
+}
+
+void LiftingStatistics::sample(Counters &c, verti v, bool success)
+{
+    record_vertex(v, success);
+
+    // Next sample after 1 to 2*weight - 1 lifts (xorshift32 generator):
+    c.random ^= c.random << 13;
+    c.random ^= c.random >> 17;
+    c.random ^= c.random << 5;
+    c.next_sample = c.attempted + 1 + c.random%(2*weight - 1);
+}
+
 SmallProgressMeasures::SmallProgressMeasures(
         const ParityGame &game, ParityGame::Player player,
         LiftingStatistics *stats, const verti *vmap, verti vmap_size )
@@ -44,6 +148,10 @@ SmallProgressMeasures::SmallProgressMeasures(
       vmap_(vmap), vmap_size_(vmap_size),
       strategy_(game.graph().V(), NO_VERTEX), dirty_(0)
 {
+    const StaticGraph &graph = game.graph();
+    liberties_.resize(graph.V());
+    for (verti v = 0; v < graph.V(); ++v) liberties_[v] = graph.outdegree(v);
+
     assert(p_ == 0 || p_ == 1);
 
     // Initialize SPM vector bounds
@@ -84,7 +192,67 @@ void SmallProgressMeasures::initialize_loops()
             ++cnt;
         }
     }
-    info("Initialized %d vert%s to top.", cnt, cnt == 1 ? "ex" : "ices");
+    info("Initialized %ld vert%s to top.", (long)cnt, cnt == 1 ? "ex" : "ices");
+    attract_top();
+}
+
+size_t SmallProgressMeasures::attract_pending()
+{
+    const StaticGraph &graph = game_.graph();
+    const size_t lifted = top_queue_.size();
+    for (size_t i = 0; i < top_queue_.size(); ++i)
+    {
+        verti v = top_queue_[i];
+        for ( const verti *it  = graph.pred_begin(v),
+                          *end = graph.pred_end(v); it != end; ++it )
+        {
+            verti u = *it;
+            if (is_top(u)) continue;
+
+            // Opponent's vertices are attracted by any top successor, and
+            // player's vertices when all successors are top:
+            if (take_max(u) || --liberties_[u] == 0)
+            {
+                strategy_[u] = v;
+                set_top(u);
+            }
+        }
+    }
+    if (top_queue_.size() > lifted)
+    {
+        debug( "Attracted %ld vertices to top.",
+               (long)(top_queue_.size() - lifted) );
+    }
+    return lifted;
+}
+
+void SmallProgressMeasures::attract_top()
+{
+    attract_pending();
+    top_queue_.clear();
+}
+
+void SmallProgressMeasures::attract_top_1(LiftingStrategy &ls)
+{
+    for (size_t i = attract_pending(); i < top_queue_.size(); ++i)
+    {
+        ls.lifted(top_queue_[i]);
+    }
+    top_queue_.clear();
+}
+
+void SmallProgressMeasures::attract_top_2(LiftingStrategy2 &ls)
+{
+    const size_t begin = attract_pending();
+    for (size_t i = begin; i < top_queue_.size(); ++i)
+    {
+        dirty_[top_queue_[i]] = false;
+    }
+    for (size_t i = begin; i < top_queue_.size(); ++i)
+    {
+        update_predecessors(top_queue_[i], ls);
+    }
+    top_queue_.clear();
 }
 
 void SmallProgressMeasures::initialize_lifting_strategy(LiftingStrategy2 &ls)
@@ -144,28 +312,34 @@ std::pair<verti, bool> SmallProgressMeasures::solve_one(LiftingStrategy &ls)
         if (lift_to(v, vec(w), compare_strict(v)))
         {
             ls.lifted(v);
+            if (!top_queue_.empty()) attract_top_1(ls);
             success = true;
         }
     }
-    if (stats_ != NULL)
-    {
-        stats_->record_lift(vmap_ && v < vmap_size_ ? vmap_[v] : v, success);
-    }
+    record_lift(v, success);
     return std::make_pair(v, success);
 }
 
 verti SmallProgressMeasures::solve_one(LiftingStrategy2 &ls)
 {
     verti v = ls.pop();
+    while (v != NO_VERTEX && is_top(v)) v = ls.pop();  // attracted to top
     if (v == NO_VERTEX) return NO_VERTEX;
 
-    assert(!is_top(v));
-
     bool success = lift_to(v, vec(get_successor(v)), compare_strict(v));
     assert(success);
+    (void)success;
     dirty_[v] = false;
     // debug_print_vertex(v);
 
+    if (!top_queue_.empty()) attract_top_2(ls);
+    update_predecessors(v, ls);
+    record_lift(v, true);
+    return v;
+}
+
+void SmallProgressMeasures::update_predecessors(verti v, LiftingStrategy2 &ls)
+{
     for ( const verti *it  = game_.graph().pred_begin(v),
                       *end = game_.graph().pred_end(v); it != end; ++it )
     {
@@ -221,12 +395,6 @@ verti SmallProgressMeasures::solve_one(LiftingStrategy2 &ls)
             }
         }
     }
-
-    if (stats_ != NULL)
-    {
-        stats_->record_lift(vmap_ && v < vmap_size_ ? vmap_[v] : v, true);
-    }
-    return v;
 }
 
 verti SmallProgressMeasures::get_strategy(verti v) const
@@ -283,7 +451,7 @@ void SmallProgressMeasures::debug_print_vertex(int v) const
     {
         for (int p = 0; p < game_.d(); ++p)
         {
-            printf(" %d", (p%2 == p_) ? 0 : vec(v)[p/2]);
+            printf(" %ld", (p%2 == p_) ? 0L : (long)vec(v)[p/2]);
         }
     }
     printf("\n");
@@ -292,7 +460,7 @@ void SmallProgressMeasures::debug_print_vertex(int v) const
 void SmallProgressMeasures::debug_print() const
 {
     printf("M =");
-    for (int p = 0; p < game_.d(); ++p) printf(" %d", (p%2 == p_) ? 0 : M_[p/2]);
+    for (int p = 0; p < game_.d(); ++p) printf(" %ld", (p%2 == p_) ? 0L : (long)M_[p/2]);
     printf("\n");
     for (verti v = 0; v < game_.graph().V(); ++v) debug_print_vertex(v);
 }
@@ -338,8 +506,8 @@ bool SmallProgressMeasures::verify_solution()
 
         if (!(game_.player(v) == p_ ? one_ok : all_ok))
         {
-            printf( "order constraint not satisfied for vertex %d with "
-                    "priority %d and player %s!\n", v, game_.priority(v),
+            printf( "order constraint not satisfied for vertex %ld with "
+                    "priority %d and player %s!\n", (long)v, game_.priority(v),
                 game_.player(v) == ParityGame::PLAYER_EVEN ? "even" :
                 game_.player(v) == ParityGame::PLAYER_ODD  ? "odd"  : "???" );
             return false;
@@ -348,6 +516,329 @@ bool SmallProgressMeasures::verify_solution()
     return true;
 }
 
+void SmallProgressMeasures::write_raw(std::ostream &os) const
+{
+    const verti V = game_.graph().V();
+    os.write((const char*)&p_, sizeof(p_));
+    os.write((const char*)&len_, sizeof(len_));
+    os.write((const char*)&V, sizeof(V));
+    os.write((const char*)M_, sizeof(verti)*len_);
+    for (verti v = 0; v < V; ++v)
+    {
+        // Top vectors are written as a single NO_VERTEX component:
+        const verti *vec_v = vec(v);
+        int n = is_top(vec_v) ? 1 : std::max(len(v), 1);
+        os.write((const char*)vec_v, sizeof(verti)*n);
+    }
+}
+
+bool SmallProgressMeasures::read_raw(std::istream &is)
+{
+    const verti V = game_.graph().V();
+    int p = -1, N = -1;
+    verti num_vertices = 0;
+    is.read((char*)&p, sizeof(p));
+    is.read((char*)&N, sizeof(N));
+    is.read((char*)&num_vertices, sizeof(num_vertices));
+    if (!is || p != p_ || N != len_ || num_vertices != V) return false;
+
+    std::vector<verti> M(len_);
+    is.read((char*)&M[0], sizeof(verti)*len_);
+    for (int n = 0; n < len_; ++n)
+    {
+        if (M[n] > M_[n]) return false;
+    }
+
+    // Read all vectors first, so nothing changes if the data is invalid:
+    std::vector<verti> data;
+    data.reserve(V);
+    for (verti v = 0; v < V && is; ++v)
+    {
+        verti x = 0;
+        is.read((char*)&x, sizeof(x));
+        data.push_back(x);
+        if (x == NO_VERTEX) continue;
+        for (int n = 0; n < len(v); ++n)
+        {
+            if (n > 0)
+            {
+                is.read((char*)&x, sizeof(x));
+                data.push_back(x);
+            }
+            if (x >= M[n]) return false;
+        }
+    }
+    if (!is) return false;
+
+    set_M(&M[0]);
+    const StaticGraph &graph = game_.graph();
+    top_queue_.clear();
+    const verti *src = &data[0];
+    for (verti v = 0; v < V; ++v)
+    {
+        liberties_[v] = graph.outdegree(v);
+        if (*src == NO_VERTEX)
+        {
+            if (!is_top(v)) set_vec_to_top(v);
+            top_queue_.push_back(v);
+            src += 1;
+        }
+        else
+        {
+            set_vec(v, src, false);
+            src += std::max(len(v), 1);
+        }
+    }
+
+    // Re-attract to all top vertices, to recompute the liberty counts:
+    attract_top();
+    return true;
+}
+
+/*! Returns a hash of the priority, owner and successors of vertex `v`, used
+    to detect which vertices changed between saving and loading measures. */
+static compat_uint64_t vertex_signature(const ParityGame &game, verti v)
+{
+    const StaticGraph &graph = game.graph();
+    compat_uint64_t h = 14695981039346656037ull;  // FNV-1a offset basis
+    h = (h ^ (compat_uint64_t)game.priority(v)) * 1099511628211ull;
+    h = (h ^ (compat_uint64_t)game.player(v)) * 1099511628211ull;
+    for ( const verti *it  = graph.succ_begin(v),
+                      *end = graph.succ_end(v); it != end; ++it )
+    {
+        h = (h ^ (compat_uint64_t)*it) * 1099511628211ull;
+    }
+    return h;
+}
+
+void SmallProgressMeasures::write_measures(std::ostream &os) const
+{
+    const verti V = game_.graph().V();
+    os << "player " << p_ << '\n';
+    for (verti v = 0; v < V; ++v)
+    {
+        os << v << ' ' << vertex_signature(game_, v);
+        const verti *vec_v = vec(v);
+        if (is_top(vec_v))
+        {
+            os << " top\n";
+            continue;
+        }
+
+        // Trailing zero components are omitted:
+        int l = len(v);
+        while (l > 0 && vec_v[l - 1] == 0) --l;
+        for (int n = 0; n < l; ++n) os << ' ' << vec_v[n];
+        os << '\n';
+    }
+}
+
+/*! Parses a non-negative decimal integer from `s` into `x`. */
+static bool parse_verti(const std::string &s, verti &x)
+{
+    if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    std::istringstream iss(s);
+    iss >> x;
+    return !iss.fail();
+}
+
+verti SmallProgressMeasures::warm_start(std::istream &is)
+{
+    const StaticGraph &graph = game_.graph();
+    const verti V = graph.V();
+
+    // Copy current vectors (which are zero, or top for vertices with loops):
+    std::vector<verti> data((size_t)len_*V, 0);
+    for (verti v = 0; v < V; ++v)
+    {
+        const verti *vec_v = vec(v);
+        std::copy( vec_v, vec_v + (is_top(vec_v) ? 1 : len(v)),
+                   &data[(size_t)len_*v] );
+    }
+
+    // Parse lines of the form "player <p>", "<v> <sig> top" or
+    // "<v> <sig> <c0> <c1> ..." (components missing at the end are zero):
+    std::vector<verti> tmp(len_), seeds;
+    std::vector<char> seeded(V, 0), unchanged(V, 0);
+    long malformed = 0;
+    int player = -1;
+    std::string line, word;
+    while (std::getline(is, line))
+    {
+        std::istringstream iss(line);
+        if (!(iss >> word) || word[0] == '#') continue;
+        if (word == "player")
+        {
+            if (!(iss >> player)) ++malformed;
+            continue;
+        }
+        if (player != p_) continue;
+
+        verti v = NO_VERTEX, x = 0;
+        compat_uint64_t sig = 0;
+        if (!parse_verti(word, v) || !(iss >> sig))
+        {
+            ++malformed;
+            continue;
+        }
+        std::fill(tmp.begin(), tmp.end(), 0);
+        bool top = false, valid = true;
+        for (int n = 0; valid && iss >> word; ++n)
+        {
+            if (n == 0 && word == "top")
+            {
+                top = true;
+            }
+            else
+            if (top || !parse_verti(word, x))
+            {
+                valid = false;
+            }
+            else
+            if (v < V && n < len(v))
+            {
+                tmp[n] = std::min(x, M_[n] - 1);
+            }
+        }
+        if (!valid)
+        {
+            ++malformed;
+            continue;
+        }
+
+        if (v >= V || vertex_signature(game_, v) != sig) continue;
+        unchanged[v] = 1;
+        verti *dst = &data[(size_t)len_*v];
+        if (is_top(dst)) continue;
+        if (top)
+        {
+            dst[0] = NO_VERTEX;
+        }
+        else
+        {
+            std::copy(tmp.begin(), tmp.begin() + len(v), dst);
+            if (std::count(dst, dst + len(v), 0) == len(v)) continue;
+        }
+        if (!seeded[v])
+        {
+            seeded[v] = 1;
+            seeds.push_back(v);
+        }
+    }
+    if (malformed > 0)
+    {
+        warn("Ignored %ld malformed lines in warm start data.", malformed);
+    }
+
+    /* A saved measure is a lower bound for the current game only if the
+       subgame reachable from its vertex is unchanged, since it may have been
+       raised by successors that no longer exist. Discard the measures of all
+       vertices that can reach a changed (or new) vertex: */
+    verti discarded = 0;
+    std::vector<verti> queue;
+    for (verti v = 0; v < V; ++v) if (!unchanged[v]) queue.push_back(v);
+    while (!queue.empty())
+    {
+        verti v = queue.back();
+        queue.pop_back();
+        for ( const verti *it  = graph.pred_begin(v),
+                          *end = graph.pred_end(v); it != end; ++it )
+        {
+            const verti u = *it;
+            if (!unchanged[u]) continue;
+            unchanged[u] = 0;
+            queue.push_back(u);
+            if (seeded[u])
+            {
+                verti *vec_u = &data[(size_t)len_*u];
+                std::fill(vec_u, vec_u + len_, 0);
+                seeded[u] = 0;
+                ++discarded;
+            }
+        }
+    }
+
+    // Reset vectors that are not supported by their successors (which may
+    // happen if the file is inconsistent), and then those of the
+    // predecessors that depended on them:
+    verti rejected = 0;
+    queue = seeds;
+    while (!queue.empty())
+    {
+        verti v = queue.back();
+        queue.pop_back();
+        if (!seeded[v] || supported(&data[0], v, &tmp[0])) continue;
+        std::fill(&data[(size_t)len_*v], &data[(size_t)len_*v] + len_, 0);
+        seeded[v] = 0;
+        ++rejected;
+        for ( const verti *it  = graph.pred_begin(v),
+                          *end = graph.pred_end(v); it != end; ++it )
+        {
+            if (seeded[*it]) queue.push_back(*it);
+        }
+    }
+
+    // Set top vectors first, since these reduce the vector space to which
+    // the remaining vectors are clamped:
+    for (size_t i = 0; i < seeds.size(); ++i)
+    {
+        verti v = seeds[i];
+        if (seeded[v] && is_top(&data[(size_t)len_*v]) && !is_top(v))
+        {
+            set_top(v);
+        }
+    }
+    for (size_t i = 0; i < seeds.size(); ++i)
+    {
+        verti v = seeds[i];
+        verti *src = &data[(size_t)len_*v];
+        if (!seeded[v] || is_top(src)) continue;
+        for (int n = 0; n < len(v); ++n) src[n] = std::min(src[n], M_[n] - 1);
+        set_vec(v, src, false);
+    }
+    attract_top();
+
+    verti count = (verti)seeds.size() - discarded - rejected;
+    info("Warm start seeded %ld vertices (%ld changed, %ld rejected).",
+         (long)count, (long)discarded, (long)rejected);
+    return count;
+}
+
+bool SmallProgressMeasures::supported( const verti *data, verti v,
+                                       verti *tmp ) const
+{
+    const StaticGraph &graph = game_.graph();
+    const int l = len(v);
+    const verti *vec_v = data + (size_t)len_*v;
+
+    // Find the extreme successor, like get_ext_succ() does:
+    const verti *ext = 0;
+    for ( const verti *it  = graph.succ_begin(v),
+                      *end = graph.succ_end(v); it != end; ++it )
+    {
+        const verti *vec_w = data + (size_t)len_*(*it);
+        int d = ext ? vector_cmp(vec_w, ext, l) : 0;
+        if (!ext || (take_max(v) ? d > 0 : d < 0)) ext = vec_w;
+    }
+    if (is_top(ext)) return true;
+    if (l == 0) return !is_top(vec_v);
+
+    // Compute the lifted vector, like set_vec() does:
+    bool carry = compare_strict(v);
+    int k = l;
+    for (int n = l - 1; n >= 0; --n)
+    {
+        tmp[n] = ext[n] + carry;
+        carry = (tmp[n] >= M_[n]);
+        if (carry) k = n;
+    }
+    if (carry) return true;
+    while (k < l) tmp[k++] = 0;
+    return vector_cmp(vec_v, tmp, l) <= 0;
+}
 
 //
 //  SmallProgressMeasuresSolver
@@ -355,9 +846,12 @@ bool SmallProgressMeasures::verify_solution()
 
 SmallProgressMeasuresSolver::SmallProgressMeasuresSolver(
     const ParityGame &game, LiftingStrategyFactory *lsf, bool alternate,
-    LiftingStatistics *stats, const verti *vmap, verti vmap_size )
+    LiftingStatistics *stats, const verti *vmap, verti vmap_size,
+    Storage storage, bool parallel )
         : ParityGameSolver(game), lsf_(lsf), alternate_(alternate),
-          stats_(stats), vmap_(vmap), vmap_size_(vmap_size)
+          stats_(stats), vmap_(vmap), vmap_size_(vmap_size), storage_(storage),
+          parallel_(parallel), checkpoint_interval_(0), last_checkpoint_(0),
+          resume_(false), resume_stage_(-1)
 {
     lsf_->ref();
 }
@@ -369,30 +863,229 @@ SmallProgressMeasuresSolver::~SmallProgressMeasuresSolver()
 
 ParityGame::Strategy SmallProgressMeasuresSolver::solve()
 {
+    load_checkpoint();
     return alternate_ ? solve_alternate() : solve_normal();
 }
 
+void SmallProgressMeasuresSolver::set_checkpoint(
+    const std::string &path, double interval, bool resume )
+{
+    checkpoint_path_     = path;
+    checkpoint_interval_ = interval;
+    last_checkpoint_     = time_now();
+    resume_              = resume;
+}
+
+void SmallProgressMeasuresSolver::set_warm_start(
+    const std::string &load_path, const std::string &save_path )
+{
+    warm_start_path_    = load_path;
+    save_measures_path_ = save_path;
+}
+
+/*! Magic string that identifies checkpoint files. */
+static const char checkpoint_magic[8] = { 'S','P','M','C','K','P','T','1' };
+
+/*! Returns a hash of the structure of `game`, used to check that a
+    checkpoint file was written for the same game. */
+static compat_uint64_t game_fingerprint(const ParityGame &game)
+{
+    // 64-bit FNV-1a hash of vertex priorities, players and successors:
+    compat_uint64_t h = 14695981039346656037ull;
+    const StaticGraph &graph = game.graph();
+    for (verti v = 0; v < graph.V(); ++v)
+    {
+        h = (h ^ (compat_uint64_t)game.priority(v)) * 1099511628211ull;
+        h = (h ^ (compat_uint64_t)game.player(v)) * 1099511628211ull;
+        for ( const verti *it  = graph.succ_begin(v),
+                          *end = graph.succ_end(v); it != end; ++it )
+        {
+            h = (h ^ (compat_uint64_t)*it) * 1099511628211ull;
+        }
+        h = (h ^ (compat_uint64_t)NO_VERTEX) * 1099511628211ull;
+    }
+    return h;
+}
+
+void SmallProgressMeasuresSolver::checkpoint( int stage,
+    const SmallProgressMeasures * const spm[], int count, bool force )
+{
+    if (checkpoint_path_.empty()) return;
+    if (!force && time_now() - last_checkpoint_ < checkpoint_interval_) return;
+    last_checkpoint_ = time_now();
+
+    // Write to a temporary file first, so an interrupted write never
+    // destroys the previous checkpoint:
+    std::string tmp_path = checkpoint_path_ + ".tmp";
+    {
+        std::ofstream ofs(tmp_path.c_str(), std::ios::binary);
+        compat_uint64_t fingerprint = game_fingerprint(game_);
+        int alternate = alternate_;
+        ofs.write(checkpoint_magic, sizeof(checkpoint_magic));
+        ofs.write((const char*)&fingerprint, sizeof(fingerprint));
+        ofs.write((const char*)&alternate, sizeof(alternate));
+        ofs.write((const char*)&stage, sizeof(stage));
+        ofs.write((const char*)&count, sizeof(count));
+        for (int i = 0; i < count; ++i)
+        {
+            // Each section is preceded by its size in bytes:
+            compat_uint64_t size = 0;
+            std::streampos pos = ofs.tellp();
+            ofs.write((const char*)&size, sizeof(size));
+            spm[i]->write_raw(ofs);
+            size = ofs.tellp() - pos - (std::streamoff)sizeof(size);
+            ofs.seekp(pos);
+            ofs.write((const char*)&size, sizeof(size));
+            ofs.seekp(0, std::ios::end);
+        }
+        if (!ofs)
+        {
+            error("Writing checkpoint to %s failed!", tmp_path.c_str());
+            return;
+        }
+    }
+    if (rename(tmp_path.c_str(), checkpoint_path_.c_str()) != 0)
+    {
+        error("Couldn't rename %s to %s!", tmp_path.c_str(),
+                                           checkpoint_path_.c_str());
+        return;
+    }
+    info("Checkpoint written to %s.", checkpoint_path_.c_str());
+}
+
+void SmallProgressMeasuresSolver::load_checkpoint()
+{
+    resume_stage_ = -1;
+    resume_spm_.clear();
+    if (!resume_ || checkpoint_path_.empty()) return;
+
+    std::ifstream ifs(checkpoint_path_.c_str(), std::ios::binary);
+    if (!ifs)
+    {
+        info("No checkpoint at %s; starting from scratch.",
+             checkpoint_path_.c_str());
+        return;
+    }
+
+    char magic[sizeof(checkpoint_magic)] = { };
+    compat_uint64_t fingerprint = 0;
+    int alternate = -1, stage = -1, count = -1;
+    ifs.read(magic, sizeof(magic));
+    ifs.read((char*)&fingerprint, sizeof(fingerprint));
+    ifs.read((char*)&alternate, sizeof(alternate));
+    ifs.read((char*)&stage, sizeof(stage));
+    ifs.read((char*)&count, sizeof(count));
+    if ( !ifs || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0 ||
+         count < 0 || count > 2 )
+    {
+        warn("%s is not a valid checkpoint file!", checkpoint_path_.c_str());
+        return;
+    }
+    if (fingerprint != game_fingerprint(game_) || alternate != alternate_)
+    {
+        info("Checkpoint at %s belongs to a different game or solver; "
+             "ignoring it.", checkpoint_path_.c_str());
+        return;
+    }
+
+    std::vector<std::string> sections(count);
+    for (int i = 0; i < count; ++i)
+    {
+        compat_uint64_t size = 0;
+        ifs.read((char*)&size, sizeof(size));
+        if (!ifs) break;
+        sections[i].resize((size_t)size);
+        if (size > 0) ifs.read(&sections[i][0], (std::streamsize)size);
+    }
+    if (!ifs)
+    {
+        warn("Checkpoint file %s is truncated!", checkpoint_path_.c_str());
+        return;
+    }
+    info("Resuming from checkpoint at %s.", checkpoint_path_.c_str());
+    resume_stage_ = stage;
+    resume_spm_.swap(sections);
+}
+
+bool SmallProgressMeasuresSolver::restore(int i, SmallProgressMeasures &spm)
+{
+    if (i >= (int)resume_spm_.size() || resume_spm_[i].empty()) return false;
+
+    std::istringstream iss(resume_spm_[i]);
+    bool success = spm.read_raw(iss);
+    if (!success) warn("Couldn't restore progress measures from checkpoint!");
+    std::string().swap(resume_spm_[i]);  // free memory
+    return success;
+}
+
+void SmallProgressMeasuresSolver::warm_start(SmallProgressMeasures &spm)
+{
+    if (warm_start_path_.empty()) return;
+    if (vmap_)
+    {
+        debug("Not warm starting subgame of size %ld.",
+              (long)game_.graph().V());
+        return;
+    }
+    std::ifstream ifs(warm_start_path_.c_str());
+    if (!ifs)
+    {
+        warn("Couldn't open %s for warm start!", warm_start_path_.c_str());
+        return;
+    }
+    spm.warm_start(ifs);
+}
+
+void SmallProgressMeasuresSolver::save_measures(
+    const SmallProgressMeasures * const spm[], int count )
+{
+    if (save_measures_path_.empty() || vmap_) return;
+    std::ofstream ofs(save_measures_path_.c_str());
+    for (int i = 0; i < count; ++i) spm[i]->write_measures(ofs);
+    ofs.close();
+    if (!ofs)
+    {
+        error("Writing progress measures to %s failed!",
+              save_measures_path_.c_str());
+        return;
+    }
+    info("Progress measures written to %s.", save_measures_path_.c_str());
+}
+
 ParityGame::Strategy SmallProgressMeasuresSolver::solve_normal()
 {
     ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
     std::vector<verti> won_by_odd;
 
+    // Solved progress measures for Even are kept for checkpoints:
+    std::auto_ptr<SmallProgressMeasures> spm_even;
+
     {
         info("Solving for Even...");
-        DenseSPM spm( game(), ParityGame::PLAYER_EVEN,
-                      stats_, vmap_, vmap_size_ );
-        std::auto_ptr<LiftingStrategy> ls(lsf_->create(game_, spm));
-        while (spm.solve_some(*ls) == 0)
+        std::auto_ptr<SmallProgressMeasures> spm(
+            create_spm( game(), ParityGame::PLAYER_EVEN,
+                        stats_, vmap_, vmap_size_, storage_ ) );
+        if (!restore(0, *spm)) warm_start(*spm);
+        std::auto_ptr<LiftingStrategy> ls(lsf_->create(game_, *spm));
+        const SmallProgressMeasures *cp[1] = { spm.get() };
+        while (spm->solve_some(*ls) == 0)
         {
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(0, cp, 1, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(0, cp, 1);
         }
-        spm.get_strategy(strategy);
-        spm.get_winning_set( ParityGame::PLAYER_ODD,
+        spm->get_strategy(strategy);
+        spm->get_winning_set( ParityGame::PLAYER_ODD,
             std::back_insert_iterator<std::vector<verti> >(won_by_odd) );
+        save_measures(cp, 1);
 #ifdef DEBUG
         info("Verifying small progress measures.");
-        assert(spm.verify_solution());
+        assert(spm->verify_solution());
 #endif
+        if (!checkpoint_path_.empty()) spm_even = spm;
     }
 
     if (!won_by_odd.empty())
@@ -417,19 +1110,27 @@ ParityGame::Strategy SmallProgressMeasuresSolver::solve_normal()
 
         // Second pass; solve subgame of vertices won by Odd:
         info("Solving for Odd...");
-        DenseSPM spm( subgame, ParityGame::PLAYER_ODD,
-                      stats_, submap, submap_size );
-        std::auto_ptr<LiftingStrategy> ls(lsf_->create(subgame, spm));
-        while (spm.solve_some(*ls) == 0)
+        std::auto_ptr<SmallProgressMeasures> spm(
+            create_spm( subgame, ParityGame::PLAYER_ODD,
+                        stats_, submap, submap_size, storage_ ) );
+        restore(1, *spm);
+        std::auto_ptr<LiftingStrategy> ls(lsf_->create(subgame, *spm));
+        const SmallProgressMeasures *cp[2] = { spm_even.get(), spm.get() };
+        while (spm->solve_some(*ls) == 0)
         {
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(1, cp, 2, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(1, cp, 2);
         }
         ParityGame::Strategy substrat(won_by_odd.size(), NO_VERTEX);
-        spm.get_strategy(substrat);
+        spm->get_strategy(substrat);
         merge_strategies(strategy, substrat, won_by_odd);
 #ifdef DEBUG
         debug("Verifying small progress measures.");
-        assert(spm.verify_solution());
+        assert(spm->verify_solution());
 #endif
     }
 
@@ -438,15 +1139,26 @@ ParityGame::Strategy SmallProgressMeasuresSolver::solve_normal()
 
 ParityGame::Strategy SmallProgressMeasuresSolver::solve_alternate()
 {
+#ifdef WITH_THREADS
+    if (parallel_ && checkpoint_path_.empty() && !omp_in_parallel())
+    {
+        return solve_alternate_concurrently<LiftingStrategy>();
+    }
+#endif
+
     // Create two SPM and two lifting strategy instances:
     std::auto_ptr<SmallProgressMeasures> spm[2];
-    spm[0].reset(new DenseSPM( game_, ParityGame::PLAYER_EVEN,
-                               stats_, vmap_, vmap_size_ ));
-    spm[1].reset(new DenseSPM( game_, ParityGame::PLAYER_ODD,
-                               stats_, vmap_, vmap_size_ ));
-
-    // Solve games alternatingly:
-    int player = 0;
+    spm[0].reset(create_spm( game_, ParityGame::PLAYER_EVEN,
+                             stats_, vmap_, vmap_size_, storage_ ));
+    spm[1].reset(create_spm( game_, ParityGame::PLAYER_ODD,
+                             stats_, vmap_, vmap_size_, storage_ ));
+    if (!restore(0, *spm[0])) warm_start(*spm[0]);
+    if (!restore(1, *spm[1])) warm_start(*spm[1]);
+    const SmallProgressMeasures *cp[2] = { spm[0].get(), spm[1].get() };
+
+    // Solve games alternatingly (starting with the game being lifted when
+    // the checkpoint was written, if resuming):
+    int player = resume_stage_ == 1 ? 1 : 0;
     bool half_solved = false;
     while (!half_solved)
     {
@@ -459,12 +1171,18 @@ ParityGame::Strategy SmallProgressMeasuresSolver::solve_alternate()
               work -= SmallProgressMeasures::work_size )
         {
             half_solved = spm[player]->solve_some(*ls) > 0;
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(player, cp, 2, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(player, cp, 2);
         }
 
         info("Propagating solved vertices to other game...");
         spm[player]->get_winning_set( (ParityGame::Player)player,
                                       SetToTopIterator(*spm[1 - player]) );
+        spm[1 - player]->attract_top();
         player = 1 - player;
     }
 
@@ -473,9 +1191,16 @@ ParityGame::Strategy SmallProgressMeasuresSolver::solve_alternate()
     std::auto_ptr<LiftingStrategy> ls(lsf_->create(game_, *spm[player]));
     while (spm[player]->solve_some(*ls) == 0)
     {
-        if (aborted()) return ParityGame::Strategy();
+        if (aborted())
+        {
+            checkpoint(player, cp, 2, true);
+            return ParityGame::Strategy();
+        }
+        checkpoint(player, cp, 2);
     }
 
+    save_measures(cp, 2);
+
     // Retrieve combined strategies:
     ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
     spm[0]->get_strategy(strategy);
@@ -484,6 +1209,138 @@ ParityGame::Strategy SmallProgressMeasuresSolver::solve_alternate()
     return strategy;
 }
 
+#ifdef WITH_THREADS
+/*! Sets `vertices[begin:end)` to top in `spm`, and returns a version 1
+    lifting strategy that accounts for the change: `ls` is notified of each
+    vertex lifted (after creating it, if it is NULL). */
+static LiftingStrategy *lift_to_top( LiftingStrategyFactory &lsf,
+    const ParityGame &game, SmallProgressMeasures &spm, LiftingStrategy *ls,
+    const std::vector<verti> &vertices, size_t begin, size_t end )
+{
+    if (ls == NULL) ls = lsf.create(game, spm);
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (spm.lift_to_top(vertices[i])) ls->lifted(vertices[i]);
+    }
+    spm.attract_top_1(*ls);
+    return ls;
+}
+
+/*! Sets `vertices[begin:end)` to top in `spm`, and returns a version 2
+    lifting strategy that accounts for the change: since the set of dirty
+    vertices must be recalculated, a new one replaces `ls` if any vertex was
+    lifted (or if `ls` is NULL). */
+static LiftingStrategy2 *lift_to_top( LiftingStrategyFactory &lsf,
+    const ParityGame &game, SmallProgressMeasures &spm, LiftingStrategy2 *ls,
+    const std::vector<verti> &vertices, size_t begin, size_t end )
+{
+    bool changed = false;
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (spm.lift_to_top(vertices[i])) changed = true;
+    }
+    spm.attract_top();
+    if (ls == NULL || changed)
+    {
+        delete ls;
+        ls = lsf.create2(game, spm);
+        spm.initialize_lifting_strategy(*ls);
+    }
+    return ls;
+}
+
+template<class LS>
+ParityGame::Strategy SmallProgressMeasuresSolver::solve_alternate_concurrently()
+{
+    // Both threads record lifts in stats_, which counts them per thread:
+    std::auto_ptr<SmallProgressMeasures> spm[2];
+    SolvedQueue queue[2];
+    for (int player = 0; player < 2; ++player)
+    {
+        spm[player].reset(create_spm( game_, (ParityGame::Player)player,
+                                      stats_, vmap_, vmap_size_, storage_ ));
+        warm_start(*spm[player]);
+        queue[player].vertices.resize(game_.graph().V());
+    }
+
+    info("Solving normal and dual game concurrently...");
+    bool solved[2] = { false, false };
+    #pragma omp parallel for num_threads(2) schedule(static, 1)
+    for (int player = 0; player < 2; ++player)
+    {
+        solved[player] = solve_side<LS>( *spm[player],
+            (ParityGame::Player)player, queue[1 - player], queue[player] );
+    }
+    if (!solved[0] || !solved[1]) return ParityGame::Strategy();
+
+    const SmallProgressMeasures *cp[2] = { spm[0].get(), spm[1].get() };
+    save_measures(cp, 2);
+
+    // Retrieve combined strategies:
+    ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
+    spm[0]->get_strategy(strategy);
+    spm[1]->get_strategy(strategy);
+
+    return strategy;
+}
+
+template<class LS>
+bool SmallProgressMeasuresSolver::solve_side( SmallProgressMeasures &spm,
+    ParityGame::Player player, SolvedQueue &in, SolvedQueue &out )
+{
+    const verti V = game_.graph().V();
+    std::vector<char> published(V, 0);
+    std::vector<verti> won;
+    std::auto_ptr<LS> ls;
+    size_t received = 0;
+    long long work = 0, interval = V;
+    for (;;)
+    {
+        // Set vertices won by the opponent in the other game to top:
+        size_t available = in.available();
+        if (!ls.get() || received < available)
+        {
+            ls.reset(lift_to_top( *lsf_, game_, spm, ls.release(),
+                                  in.vertices, received, available ));
+            received = available;
+        }
+
+        bool solved = spm.solve_some(*ls) > 0;
+        if (aborted()) return false;
+
+        /* Computing the winning set takes time linear in the size of the
+           game, so it is done after lifting for a similar amount of time
+           (and less often while it finds nothing new). */
+        work += SmallProgressMeasures::work_size;
+        if (solved || work >= interval)
+        {
+            const size_t old_size = out.written;
+            won.clear();
+            spm.get_winning_set(player, std::back_inserter(won));
+            for (std::vector<verti>::const_iterator it = won.begin();
+                 it != won.end(); ++it)
+            {
+                if (!published[*it])
+                {
+                    published[*it] = true;
+                    out.push(*it);
+                }
+            }
+            out.flush();
+            interval = out.written > old_size ? V : 2*interval;
+            work = 0;
+        }
+        if (solved)
+        {
+            info( "%s game solved; published %ld vertices.",
+                  player == ParityGame::PLAYER_EVEN ? "Normal" : "Dual",
+                  (long)out.written );
+            return true;
+        }
+    }
+}
+#endif
+
 void SmallProgressMeasuresSolver::preprocess_game(ParityGame &game)
 {
     StaticGraph &graph = const_cast<StaticGraph&>(game.graph());  // HACK
@@ -518,15 +1375,83 @@ void SmallProgressMeasuresSolver::preprocess_game(ParityGame &game)
 }
 
 
+/*! Creates a FixedDenseSPM with vectors of at most `MaxLen` components,
+    using the narrowest component type that can store vectors with bounds up
+    to `max_M`. */
+template<int MaxLen>
+static SmallProgressMeasures *create_fixed_spm(
+    const ParityGame &game, ParityGame::Player player,
+    LiftingStatistics *stats, const verti *vmap, verti vmap_size, verti max_M )
+{
+    if (FixedDenseSPM<MaxLen, compat_uint8_t>::fits(max_M))
+    {
+        return new FixedDenseSPM<MaxLen, compat_uint8_t>(
+            game, player, stats, vmap, vmap_size );
+    }
+    if (FixedDenseSPM<MaxLen, compat_uint16_t>::fits(max_M))
+    {
+        return new FixedDenseSPM<MaxLen, compat_uint16_t>(
+            game, player, stats, vmap, vmap_size );
+    }
+#ifdef WITH_64BIT_INDICES
+    if (FixedDenseSPM<MaxLen, compat_uint32_t>::fits(max_M))
+    {
+        return new FixedDenseSPM<MaxLen, compat_uint32_t>(
+            game, player, stats, vmap, vmap_size );
+    }
+#endif
+    return new FixedDenseSPM<MaxLen>(game, player, stats, vmap, vmap_size);
+}
+
+SmallProgressMeasures *SmallProgressMeasuresSolver::create_spm(
+    const ParityGame &game, ParityGame::Player player,
+    LiftingStatistics *stats, const verti *vmap, verti vmap_size,
+    Storage storage )
+{
+    if (storage == STORAGE_SPARSE)
+    {
+        return new SparseSPM(game, player, stats, vmap, vmap_size);
+    }
+    if (storage == STORAGE_POOL)
+    {
+        return new PoolSPM(game, player, stats, vmap, vmap_size);
+    }
+
+    // Vector length and maximum bound as computed by the constructor of
+    // SmallProgressMeasures:
+    int len = (game.d() + (int)player)/2;
+    verti max_M = 0;
+    for (int prio = 1 - (int)player; prio < game.d(); prio += 2)
+    {
+        max_M = std::max(max_M, game.cardinality(prio) + 1);
+    }
+
+    if (len <= 2)
+    {
+        return create_fixed_spm<2>(game, player, stats, vmap, vmap_size, max_M);
+    }
+    if (len <= 4)
+    {
+        return create_fixed_spm<4>(game, player, stats, vmap, vmap_size, max_M);
+    }
+    if (len <= 8)
+    {
+        return create_fixed_spm<8>(game, player, stats, vmap, vmap_size, max_M);
+    }
+    return new DenseSPM(game, player, stats, vmap, vmap_size);
+}
+
+
 //
 //  SmallProgressMeasuresSolver2
 //
 
 SmallProgressMeasuresSolver2::SmallProgressMeasuresSolver2(
     const ParityGame &game, LiftingStrategyFactory *lsf, bool alternate,
-    LiftingStatistics *stats, const verti *vmap, verti vmap_size )
-        : SmallProgressMeasuresSolver( game, lsf, alternate,
-                                       stats, vmap, vmap_size)
+    LiftingStatistics *stats, const verti *vmap, verti vmap_size,
+    Storage storage, bool parallel )
+        : SmallProgressMeasuresSolver( game, lsf, alternate, stats,
+                                       vmap, vmap_size, storage, parallel )
 {
 }
 
@@ -539,23 +1464,36 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_normal()
     ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
     std::vector<verti> won_by_odd;
 
+    // Solved progress measures for Even are kept for checkpoints:
+    std::auto_ptr<SmallProgressMeasures> spm_even;
+
     {
         info("Solving for Even...");
-        DenseSPM spm( game(), ParityGame::PLAYER_EVEN,
-                      stats_, vmap_, vmap_size_ );
-        std::auto_ptr<LiftingStrategy2> ls(lsf_->create2(game_, spm));
-        spm.initialize_lifting_strategy(*ls);
-        while (spm.solve_some(*ls) == 0)
+        std::auto_ptr<SmallProgressMeasures> spm(
+            create_spm( game(), ParityGame::PLAYER_EVEN,
+                        stats_, vmap_, vmap_size_, storage_ ) );
+        if (!restore(0, *spm)) warm_start(*spm);
+        std::auto_ptr<LiftingStrategy2> ls(lsf_->create2(game_, *spm));
+        spm->initialize_lifting_strategy(*ls);
+        const SmallProgressMeasures *cp[1] = { spm.get() };
+        while (spm->solve_some(*ls) == 0)
         {
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(0, cp, 1, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(0, cp, 1);
         }
-        spm.get_strategy(strategy);
-        spm.get_winning_set( ParityGame::PLAYER_ODD,
+        spm->get_strategy(strategy);
+        spm->get_winning_set( ParityGame::PLAYER_ODD,
             std::back_insert_iterator<std::vector<verti> >(won_by_odd) );
+        save_measures(cp, 1);
 #ifdef DEBUG
         debug("Verifying small progress measures.");
-        assert(spm.verify_solution());
+        assert(spm->verify_solution());
 #endif
+        if (!checkpoint_path_.empty()) spm_even = spm;
     }
 
     if (!won_by_odd.empty())
@@ -580,20 +1518,28 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_normal()
 
         // Second pass; solve subgame of vertices won by Odd:
         info("Solving for Odd...");
-        DenseSPM spm( subgame, ParityGame::PLAYER_ODD,
-                      stats_, submap, submap_size );
-        std::auto_ptr<LiftingStrategy2> ls(lsf_->create2(subgame, spm));
-        spm.initialize_lifting_strategy(*ls);
-        while (spm.solve_some(*ls) == 0)
+        std::auto_ptr<SmallProgressMeasures> spm(
+            create_spm( subgame, ParityGame::PLAYER_ODD,
+                        stats_, submap, submap_size, storage_ ) );
+        restore(1, *spm);
+        std::auto_ptr<LiftingStrategy2> ls(lsf_->create2(subgame, *spm));
+        spm->initialize_lifting_strategy(*ls);
+        const SmallProgressMeasures *cp[2] = { spm_even.get(), spm.get() };
+        while (spm->solve_some(*ls) == 0)
         {
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(1, cp, 2, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(1, cp, 2);
         }
         ParityGame::Strategy substrat(won_by_odd.size(), NO_VERTEX);
-        spm.get_strategy(substrat);
+        spm->get_strategy(substrat);
         merge_strategies(strategy, substrat, won_by_odd);
 #ifdef DEBUG
         debug("Verifying small progress measures.");
-        assert(spm.verify_solution());
+        assert(spm->verify_solution());
 #endif
     }
 
@@ -602,15 +1548,26 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_normal()
 
 ParityGame::Strategy SmallProgressMeasuresSolver2::solve_alternate()
 {
+#ifdef WITH_THREADS
+    if (parallel_ && checkpoint_path_.empty() && !omp_in_parallel())
+    {
+        return solve_alternate_concurrently<LiftingStrategy2>();
+    }
+#endif
+
     // Create two SPM and two lifting strategy instances:
     std::auto_ptr<SmallProgressMeasures> spm[2];
-    spm[0].reset(new DenseSPM( game_, ParityGame::PLAYER_EVEN,
-                               stats_, vmap_, vmap_size_ ));
-    spm[1].reset(new DenseSPM( game_, ParityGame::PLAYER_ODD,
-                               stats_, vmap_, vmap_size_ ));
-
-    // Solve games alternatingly:
-    int player = 0;
+    spm[0].reset(create_spm( game_, ParityGame::PLAYER_EVEN,
+                             stats_, vmap_, vmap_size_, storage_ ));
+    spm[1].reset(create_spm( game_, ParityGame::PLAYER_ODD,
+                             stats_, vmap_, vmap_size_, storage_ ));
+    if (!restore(0, *spm[0])) warm_start(*spm[0]);
+    if (!restore(1, *spm[1])) warm_start(*spm[1]);
+    const SmallProgressMeasures *cp[2] = { spm[0].get(), spm[1].get() };
+
+    // Solve games alternatingly (starting with the game being lifted when
+    // the checkpoint was written, if resuming):
+    int player = resume_stage_ == 1 ? 1 : 0;
     bool half_solved = false;
     while (!half_solved)
     {
@@ -622,12 +1579,18 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_alternate()
               work -= SmallProgressMeasures::work_size )
         {
             half_solved = spm[player]->solve_some(*ls) > 0;
-            if (aborted()) return ParityGame::Strategy();
+            if (aborted())
+            {
+                checkpoint(player, cp, 2, true);
+                return ParityGame::Strategy();
+            }
+            checkpoint(player, cp, 2);
         }
 
         info("Propagating solved vertices to other game...");
         spm[player]->get_winning_set( (ParityGame::Player)player,
                                       SetToTopIterator(*spm[1 - player]) );
+        spm[1 - player]->attract_top();
         player = 1 - player;
     }
 
@@ -637,9 +1600,16 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_alternate()
     spm[player]->initialize_lifting_strategy(*ls);
     while (spm[player]->solve_some(*ls) == 0)
     {
-        if (aborted()) return ParityGame::Strategy();
+        if (aborted())
+        {
+            checkpoint(player, cp, 2, true);
+            return ParityGame::Strategy();
+        }
+        checkpoint(player, cp, 2);
     }
 
+    save_measures(cp, 2);
+
     // Retrieve combined strategies:
     ParityGame::Strategy strategy(game_.graph().V(), NO_VERTEX);
     spm[0]->get_strategy(strategy);
@@ -655,8 +1625,10 @@ ParityGame::Strategy SmallProgressMeasuresSolver2::solve_alternate()
 
 SmallProgressMeasuresSolverFactory::SmallProgressMeasuresSolverFactory(
         LiftingStrategyFactory *lsf, int version, bool alt,
-        LiftingStatistics *stats )
-    : lsf_(lsf), version_(version), alt_(alt), stats_(stats)
+        LiftingStatistics *stats, SmallProgressMeasuresSolver::Storage storage,
+        bool parallel )
+    : lsf_(lsf), version_(version), alt_(alt), stats_(stats), storage_(storage),
+      parallel_(parallel), checkpoint_interval_(0), resume_(false)
 {
     lsf_->ref();
 }
@@ -670,17 +1642,41 @@ ParityGameSolver *SmallProgressMeasuresSolverFactory::create(
     const ParityGame &game, const verti *vmap, verti vmap_size )
 {
     assert(version_ == 1 || version_ == 2);
+    SmallProgressMeasuresSolver *solver = 0;
     if (version_ == 1)
     {
-        return new SmallProgressMeasuresSolver(
-            game, lsf_, alt_, stats_, vmap, vmap_size );
+        solver = new SmallProgressMeasuresSolver(
+            game, lsf_, alt_, stats_, vmap, vmap_size, storage_, parallel_ );
     }
     if (version_ == 2)
     {
-        return new SmallProgressMeasuresSolver2(
-            game, lsf_, alt_, stats_, vmap, vmap_size );
+        solver = new SmallProgressMeasuresSolver2(
+            game, lsf_, alt_, stats_, vmap, vmap_size, storage_, parallel_ );
     }
-    return 0;
+    if (solver && !checkpoint_path_.empty())
+    {
+        solver->set_checkpoint(checkpoint_path_, checkpoint_interval_, resume_);
+    }
+    if (solver)
+    {
+        solver->set_warm_start(warm_start_path_, save_measures_path_);
+    }
+    return solver;
+}
+
+void SmallProgressMeasuresSolverFactory::set_checkpoint(
+    const std::string &path, double interval, bool resume )
+{
+    checkpoint_path_     = path;
+    checkpoint_interval_ = interval;
+    resume_              = resume;
+}
+
+void SmallProgressMeasuresSolverFactory::set_warm_start(
+    const std::string &load_path, const std::string &save_path )
+{
+    warm_start_path_    = load_path;
+    save_measures_path_ = save_path;
 }
 
 //
@@ -720,3 +1716,261 @@ void DenseSPM::set_vec_to_top(verti v)
 {
     spm_[(size_t)len_*v] = NO_VERTEX;
 }
+
+
+//
+//  SparseSPM
+//
+
+SparseSPM::SparseSPM( const ParityGame &game, ParityGame::Player player,
+                      LiftingStatistics *stats,
+                      const verti *vertex_map, verti vertex_map_size )
+    : SmallProgressMeasures(game, player, stats, vertex_map, vertex_map_size),
+      block_bits_(6), vec_buf_((size_t)vec_buffers*len_), vec_buf_next_(0)
+{
+    const verti V = game.graph().V();
+
+    // Reduce block size until relative offsets fit in 16 bits:
+    while (block_bits_ > 0 && ((size_t)len_ << block_bits_) > 0xffff)
+    {
+        --block_bits_;
+    }
+
+    // Compute offsets (every vector takes at least one element, so top
+    // values can be represented):
+    const verti mask = ((verti)1 << block_bits_) - 1;
+    block_  = new size_t[(V >> block_bits_) + 1];
+    offset_ = new compat_uint16_t[V];
+    size_t pos = 0;
+    for (verti v = 0; v < V; ++v)
+    {
+        if ((v & mask) == 0) block_[v >> block_bits_] = pos;
+        offset_[v] = (compat_uint16_t)(pos - block_[v >> block_bits_]);
+        pos += std::max(len(v), 1);
+    }
+    spm_ = new verti[pos]();
+    info( "Sparse SPM storage uses %ld of %ld vector components.",
+          (long)pos, (long)((size_t)len_*V) );
+
+    initialize_loops();
+}
+
+SparseSPM::~SparseSPM()
+{
+    delete[] spm_;
+    delete[] block_;
+    delete[] offset_;
+}
+
+const verti *SparseSPM::vec(verti v) const
+{
+    const verti *src = stored_vec(v);
+    const int l = len(v);
+    if (l == len_ && !is_top(src)) return src;
+
+    // Return a zero-padded copy of the vector:
+    verti *dst = &vec_buf_[(size_t)vec_buf_next_*len_];
+    vec_buf_next_ = (vec_buf_next_ + 1)%vec_buffers;
+    if (is_top(src))
+    {
+        dst[0] = NO_VERTEX;
+        std::fill(dst + 1, dst + len_, 0);
+    }
+    else
+    {
+        std::copy(src, src + l, dst);
+        std::fill(dst + l, dst + len_, 0);
+    }
+    return dst;
+}
+
+int SparseSPM::vector_cmp(verti v, verti w, int N) const
+{
+    // Compares stored vectors directly, treating missing components as zero:
+    const verti *vec1 = stored_vec(v), *vec2 = stored_vec(w);
+    if (is_top(vec1)) return is_top(vec2) ? 0 : +1;
+    if (is_top(vec2)) return -1;
+
+    const int len1 = std::min(len(v), N), len2 = std::min(len(w), N);
+    for (int n = 0; n < N; ++n)
+    {
+        verti x = n < len1 ? vec1[n] : 0, y = n < len2 ? vec2[n] : 0;
+        if (x != y) return x < y ? -1 : +1;
+    }
+    return 0;
+}
+
+void SparseSPM::set_vec(verti v, const verti src[], bool carry)
+{
+    verti *dst = stored_vec(v);
+    const int l = len(v);                   // l: vector length
+    int k = l;                              // k: position of last overflow
+    for (int n = l - 1; n >= 0; --n)
+    {
+        dst[n] = src[n] + carry;
+        carry = (dst[n] >= M_[n]);
+        if (carry) k = n;
+    }
+    while (k < l) dst[k++] = 0;
+    if (carry) set_top(v);
+}
+
+void SparseSPM::set_vec_to_top(verti v)
+{
+    stored_vec(v)[0] = NO_VERTEX;
+}
+
+
+//
+//  PoolSPM
+//
+
+const PoolSPM::handle_t PoolSPM::NO_HANDLE;
+
+PoolSPM::PoolSPM( const ParityGame &game, ParityGame::Player player,
+                  LiftingStatistics *stats,
+                  const verti *vertex_map, verti vertex_map_size )
+    : SmallProgressMeasures(game, player, stats, vertex_map, vertex_map_size),
+      handle_(new handle_t[game.graph().V()]), buckets_(16, NO_HANDLE),
+      free_(NO_HANDLE), size_(0), max_size_(0), tmp_(len_)
+{
+    // Initially, all vertices share the zero vector:
+    const verti V = game.graph().V();
+    if (V > 0)
+    {
+        handle_t h = intern(&tmp_[0]);
+        refs_[h] = V;
+        std::fill(handle_, handle_ + V, h);
+    }
+    initialize_loops();
+}
+
+PoolSPM::~PoolSPM()
+{
+    info( "Vector pool stored at most %ld distinct vectors for %ld vertices.",
+          (long)max_size_, (long)game_.graph().V() );
+    delete[] handle_;
+    for (size_t i = 0; i < chunks_.size(); ++i) delete[] chunks_[i];
+}
+
+int PoolSPM::vector_cmp(verti v, verti w, int N) const
+{
+    if (handle_[v] == handle_[w]) return 0;
+    return SmallProgressMeasures::vector_cmp(v, w, N);
+}
+
+void PoolSPM::set_vec(verti v, const verti src[], bool carry)
+{
+    verti *dst = &tmp_[0];
+    const int l = len(v);                   // l: vector length
+    int k = l;                              // k: position of last overflow
+    for (int n = l - 1; n >= 0; --n)
+    {
+        dst[n] = src[n] + carry;
+        carry = (dst[n] >= M_[n]);
+        if (carry) k = n;
+    }
+    std::fill(dst + k, dst + len_, 0);
+    if (carry)
+    {
+        set_top(v);
+    }
+    else
+    {
+        // Intern first, so an unchanged vector is not removed from the pool:
+        handle_t h = intern(dst);
+        release(handle_[v]);
+        handle_[v] = h;
+    }
+}
+
+void PoolSPM::set_vec_to_top(verti v)
+{
+    std::fill(tmp_.begin(), tmp_.end(), 0);
+    tmp_[0] = NO_VERTEX;
+    handle_t h = intern(&tmp_[0]);
+    release(handle_[v]);
+    handle_[v] = h;
+}
+
+compat_uint32_t PoolSPM::hash(const verti vec[]) const
+{
+    // FNV-1a hash over vector components:
+    compat_uint32_t h = 2166136261u;
+    for (int n = 0; n < len_; ++n)
+    {
+        h = (h ^ (compat_uint32_t)vec[n])*16777619u;
+    }
+    return h;
+}
+
+PoolSPM::handle_t PoolSPM::intern(const verti vec[])
+{
+    const compat_uint32_t h = hash(vec);
+    const size_t b = h & (buckets_.size() - 1);
+    for (handle_t i = buckets_[b]; i != NO_HANDLE; i = next_[i])
+    {
+        if (hash_[i] == h && std::equal(vec, vec + len_, pool_vec(i)))
+        {
+            ++refs_[i];
+            return i;
+        }
+    }
+
+    // Add a new vector to the pool, reusing an unused handle if possible:
+    handle_t i = free_;
+    if (i != NO_HANDLE)
+    {
+        free_ = next_[i];
+    }
+    else
+    {
+        if (refs_.size() >= (size_t)NO_HANDLE)
+        {
+            fatal("Too many distinct progress measure vectors to pool!");
+        }
+        i = (handle_t)refs_.size();
+        if ((i & ((1 << chunk_bits) - 1)) == 0)
+        {
+            chunks_.push_back(new verti[(size_t)len_ << chunk_bits]);
+        }
+        refs_.push_back(0);
+        hash_.push_back(0);
+        next_.push_back(NO_HANDLE);
+    }
+    std::copy(vec, vec + len_, pool_vec(i));
+    refs_[i] = 1;
+    hash_[i] = h;
+    next_[i] = buckets_[b];
+    buckets_[b] = i;
+    if (++size_ > max_size_) max_size_ = size_;
+    if (size_ > buckets_.size()) grow_buckets();
+    return i;
+}
+
+void PoolSPM::release(handle_t h)
+{
+    assert(refs_[h] > 0);
+    if (--refs_[h] > 0) return;
+
+    // Unlink from hash chain and add to free list:
+    handle_t *p = &buckets_[hash_[h] & (buckets_.size() - 1)];
+    while (*p != h) p = &next_[*p];
+    *p = next_[h];
+    next_[h] = free_;
+    free_ = h;
+    --size_;
+}
+
+void PoolSPM::grow_buckets()
+{
+    buckets_.assign(2*buckets_.size(), NO_HANDLE);
+    const size_t mask = buckets_.size() - 1;
+    for (handle_t i = 0; i < (handle_t)refs_.size(); ++i)
+    {
+        if (refs_[i] == 0) continue;
+        handle_t &b = buckets_[hash_[i] & mask];
+        next_[i] = b;
+        b = i;
+    }
+}
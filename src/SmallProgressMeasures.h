@@ -13,6 +13,9 @@
 #include "ParityGameSolver.h"
 #include "LiftingStrategy.h"
 #include "Logger.h"
+#include "vector_cmp.h"
+#include <iosfwd>
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -23,12 +26,36 @@
 
 /*! \ingroup SmallProgressMeasures
 
-    Object used to collect statistics when solving using the SPM algorithm */
+    Lifting statistics policies, one of which is selected at compile time by
+    defining SPM_STATS (the default is SPM_STATS_FULL). */
+#define SPM_STATS_OFF       0   //!< no statistics are collected
+#define SPM_STATS_GLOBAL    1   //!< total lifts only
+#define SPM_STATS_SAMPLED   2   //!< total lifts, and per-vertex estimates
+#define SPM_STATS_FULL      3   //!< total lifts, and exact per-vertex counts
+
+#ifndef SPM_STATS
+#define SPM_STATS SPM_STATS_FULL
+#endif
+
+/*! Average number of lifts per sample with SPM_STATS_SAMPLED. */
+#ifndef SPM_STATS_SAMPLE_RATE
+#define SPM_STATS_SAMPLE_RATE 64
+#endif
+
+/*! \ingroup SmallProgressMeasures
+
+    Object used to collect statistics when solving using the SPM algorithm.
+
+    Which statistics are collected depends on the SPM_STATS policy. Totals are
+    counted separately by each thread, in its own cache line, and summed when
+    queried, so lifts may be recorded by several threads at once. */
 class LiftingStatistics
 {
 public:
-    /*! Construct a statistics object for the given game. */
+    /*! Construct a statistics object for the given game. Solving is aborted
+        once `max_lifts` lifts have been attempted (if non-negative). */
     LiftingStatistics(const ParityGame &game, long long max_lifts = -1);
+    ~LiftingStatistics();
 
 #if 0
     /*! Merge statistics from a given object into this object, using the given
@@ -37,30 +64,90 @@ public:
     void merge(const LiftingStatistics &other, const verti *mapping = NULL);
 #endif
 
-    long long lifts_attempted() const { return lifts_attempted_; }
-    long long lifts_succeeded() const { return lifts_succeeded_; }
-    long long lifts_attempted(verti v) const { return vertex_stats_[v].first; }
-    long long lifts_succeeded(verti v) const { return vertex_stats_[v].second; }
+    /*! Returns whether per-vertex counts are collected. With the sampled
+        policy, these counts are estimates. */
+    static bool per_vertex() { return SPM_STATS >= SPM_STATS_SAMPLED; }
 
-    void add_lifts_attempted(long long count) { lifts_attempted_ += count; }
-    void add_lifts_succeeded(long long count) { lifts_succeeded_ += count; }
+    long long lifts_attempted() const;
+    long long lifts_succeeded() const;
+    long long lifts_attempted(verti v) const
+    {
+        return per_vertex() ? (long long)vertex_stats_[v].attempted*weight : 0;
+    }
+    long long lifts_succeeded(verti v) const
+    {
+        return per_vertex() ? (long long)vertex_stats_[v].succeeded*weight : 0;
+    }
+
+    void add_lifts_attempted(long long count);
+    void add_lifts_succeeded(long long count);
     void add_lifts_attempted(verti v, long long count)
     {
-        vertex_stats_[v].first += count;
+        if (per_vertex()) vertex_stats_[v].attempted += count/weight;
     }
     void add_lifts_succeeded(verti v, long long count)
     {
-        vertex_stats_[v].second += count;
+        if (per_vertex()) vertex_stats_[v].succeeded += count/weight;
     }
 
 private:
-    void record_lift(verti v, bool success);
+    LiftingStatistics(const LiftingStatistics &);
+    LiftingStatistics &operator=(const LiftingStatistics &);
+
+    inline void record_lift(verti v, bool success);
     friend class SmallProgressMeasures;
 
+    static const int cache_line_size = 64;
+
+    //! Maximum number of threads with their own counters.
+    static const int max_threads = 64;
+
+    //! Number of lifts represented by each per-vertex count.
+    static const int weight =
+        SPM_STATS == SPM_STATS_SAMPLED ? SPM_STATS_SAMPLE_RATE : 1;
+
+    //! Lifting attempts between checks of the total against max_lifts_.
+    static const long long check_interval = 1024;
+
+    //! Counters of a single thread, padded to fill a cache line.
+    struct Counters
+    {
+        long long       attempted;      //!< lifting attempts
+        long long       succeeded;      //!< successful lifts
+        long long       next_check;     //!< attempts at next max_lifts_ check
+        long long       next_sample;    //!< attempts at next sampled lift
+        compat_uint32_t random;         //!< sampling random number state
+        char padding[ cache_line_size - 4*sizeof(long long)
+                                      - sizeof(compat_uint32_t) ];
+    };
+
+    //! Per-vertex counts (32 bits, to halve the memory traffic).
+    struct VertexCounts
+    {
+        compat_uint32_t attempted, succeeded;
+    };
+
+    /*! Returns the counters of the calling thread, or NULL if the thread has
+        none (in which case the shared counters must be updated atomically
+        instead). */
+    inline Counters *own_counters();
+
+    void record_lift_shared(verti v, bool success);
+    void record_vertex(verti v, bool success);
+    void check_max_lifts(Counters &c);
+    void sample(Counters &c, verti v, bool success);
+
 private:
-    long long lifts_attempted_, lifts_succeeded_;
-    std::vector<std::pair<long long, long long> > vertex_stats_;
-    long long max_lifts_;
+    char                        *buf_;          //!< memory for counters_
+    Counters                    *counters_;     //!< per thread, plus shared
+    std::vector<VertexCounts>   vertex_stats_;  //!< per-vertex counts
+    long long                   max_lifts_;     //!< abort after this many
+
+    /*! Index of the calling thread's counters (or -1 if not yet assigned). */
+    static COMPAT_THREAD_LOCAL int thread_index_;
+
+    /*! Number of thread indices assigned so far. */
+    static int num_thread_indices_;
 };
 
 /*! \ingroup SmallProgressMeasures
@@ -80,6 +167,13 @@ private:
     two-way approach to propagate information from the dual game, and the MPI
     recursive solver.
 
+    Whenever a vertex is set to top, the vertices in the opponent's attractor
+    set to it are set to top too (as lifting would eventually do) instead of
+    waiting for them to be lifted one by one. Pending top vertices are kept in
+    a queue, and for vertices controlled by the player, the number of
+    successors that are not top yet is counted down (like the liberties in
+    make_attractor_set_2()).
+
     Note that this is an abstract base class: subclasses may implement different
     storage formats for the progress measure vectors.
 */
@@ -105,10 +199,10 @@ public:
                 zero, the game is succesfully solved.
         \see initialize_lifting_strategy()
     */
-    long long solve_some( LiftingStrategy &ls,
-                          long long max_attempts = work_size );
-    long long solve_some( LiftingStrategy2 &ls,
-                          long long max_attempts = work_size );
+    virtual long long solve_some( LiftingStrategy &ls,
+                                  long long max_attempts = work_size );
+    virtual long long solve_some( LiftingStrategy2 &ls,
+                                  long long max_attempts = work_size );
 
     /*! Performs one lifting attempt, and returns the index of the vertex and
         whether lifting succeeded. Returns NO_VERTEX if no more vertices were
@@ -136,6 +230,23 @@ public:
         and returns whether it changed: */
     inline bool lift_to_top(verti v);
 
+    /*! Sets the opponent's attractor to the vertices that were set to top
+        since the last call to top as well, without notifying any lifting
+        strategy. This should be called after lift_to_top() before a lifting
+        strategy is (re)initialized. */
+    void attract_top();
+
+    /*! Like attract_top(), but notifies `ls` of each attracted vertex as if
+        it was lifted. (Vertices set to top before the call are assumed to be
+        known to the lifting strategy already.) */
+    void attract_top_1(LiftingStrategy &ls);
+
+    /*! Like attract_top_1() for version 2 lifting strategies: predecessors
+        of attracted vertices are updated as in update_predecessors(), while
+        attracted vertices that are still queued in `ls` must be skipped when
+        they are popped. */
+    void attract_top_2(LiftingStrategy2 &ls);
+
     /*! Sets the given vertex's progress measure to the given value, if this
         is greater than the current value, and returns whether it changed.
         val[] must be an array of length len(v). If carry is set, the new
@@ -153,6 +264,35 @@ public:
     /*! For debugging: verify that the current state describes a valid SPM */
     bool verify_solution();
 
+    /*! Writes the progress measure vectors and the vector space bounds to
+        `os` in a compact binary format: only the first len(v) components of
+        each vector are written. The lifting strategy state is not included,
+        since it can be recomputed from the vectors. */
+    void write_raw(std::ostream &os) const;
+
+    /*! Reads progress measures written by write_raw() for the same game and
+        player. Returns false (without changing the current progress measures)
+        if the data is invalid or was written for a different game. */
+    bool read_raw(std::istream &is);
+
+    /*! Writes the progress measure vectors to `os` in a text format keyed by
+        vertex index, which can be read back by warm_start(). Each vector is
+        preceded by a signature of the vertex's priority, owner and
+        successors. */
+    void write_measures(std::ostream &os) const;
+
+    /*! Seeds the progress measures with those for this player read from `is`
+        (in the format written by write_measures()) and returns the number of
+        vertices seeded. This must be called before lifting starts.
+
+        A saved measure is used only if no vertex reachable from its vertex
+        (including the vertex itself) has a different priority, owner or set
+        of successors than when the measures were saved, since only then is
+        it guaranteed not to exceed the least fixed point for this game.
+        Vectors that are not supported by their successors are reset to zero
+        too, and components are clamped to the current vector space. */
+    verti warm_start(std::istream &is);
+
     /*! Return the parity to be solved. */
     const ParityGame &game() const { return game_; }
 
@@ -209,21 +349,61 @@ protected:
 
     /*! Set the SPM vector for vertex `v` to top value. This can decrease the
         vector space, but nothing else; e.g, the lifting strategy is not
-        notified of the lift. */
+        notified of the lift (though `v` is queued for attract_top()). */
     inline void set_top(verti v);
 
+    /*! Sets the opponent's attractor to pending top vertices to top, and
+        returns the index into top_queue_ where the newly attracted vertices
+        start. The caller must clear top_queue_ afterwards. */
+    size_t attract_pending();
+
+    /*! Returns whether the measure of `v` in `data` (which holds len()
+        components for each vertex) is at most the value that lifting `v`
+        would assign given the measures of its successors in `data`. `tmp`
+        must have room for len() components. */
+    bool supported(const verti *data, verti v, verti *tmp) const;
+
+    /*! After vertex `v` has been lifted, updates the cached successors and
+        dirty flags of its predecessors, and pushes or bumps them in `ls`. */
+    void update_predecessors(verti v, LiftingStrategy2 &ls);
+
+    /*! Records a lifting attempt for vertex `v` in the statistics object
+        (if there is one), mapping `v` through the vertex map. Even with
+        SPM_STATS_OFF, the total is counted if a maximum number of lifts was
+        set, since that determines when solving is aborted. */
+    void record_lift(verti v, bool success)
+    {
+#if SPM_STATS >= SPM_STATS_SAMPLED
+        if (stats_ != NULL)
+        {
+            stats_->record_lift(vmap_ && v < vmap_size_ ? vmap_[v] : v, success);
+        }
+#elif SPM_STATS == SPM_STATS_GLOBAL
+        (void)v;
+        if (stats_ != NULL) stats_->record_lift(NO_VERTEX, success);
+#else
+        (void)v;
+        if (stats_ != NULL && stats_->max_lifts_ >= 0)
+        {
+            stats_->record_lift(NO_VERTEX, success);
+        }
+#endif
+    }
+
 private:
     SmallProgressMeasures(const SmallProgressMeasures &);
     SmallProgressMeasures &operator=(const SmallProgressMeasures &);
 
-private:
+protected:
     /*! Compares the first `N` elements of the given SPM vectors and returns
         -1, 0 or 1 to indicate that v is smaller than, equal to, or larger than
         w (respectively). */
     inline int vector_cmp(const verti vec1[], const verti vec2[], int N) const;
 
-    /*! Compares `N` elements of the SPM vectors for the given vertices. */
-    inline int vector_cmp(verti v, verti w, int N) const;
+    /*! Compares `N` elements of the SPM vectors for the given vertices.
+        Derived classes may override this to compare the vectors without
+        calling vec(). */
+    virtual int vector_cmp(verti v, verti w, int N) const;
 
     /*! Returns whehter vertex `v` is lifted to the maximum successor (true)
         or minimum successor (false), which in turn depends on whether it is
@@ -235,6 +415,13 @@ private:
         parity different from the current player). */
     inline bool compare_strict(verti v) const { return game_.priority(v)%2 != p_; }
 
+    //! Maximum number of successors compared per call to vector_ext_best.
+    static const int ext_batch_size = 32;
+
+    /*! Minimum vector length for which vector_cmp_best and vector_ext_best
+        are used; shorter vectors are compared inline. */
+    static const int ext_kernel_min_len = 8;
+
     /*! Returns the minimum or maximum successor for vertex `v`,
         depending on whether take_max is false or true (respectively). */
     inline verti get_ext_succ(verti v, bool take_max) const;
@@ -262,8 +449,12 @@ private:
     // Allow selected lifting strategies to access the SPM internals:
     friend class PredecessorLiftingStrategy;
     friend class MaxMeasureLiftingStrategy2;
+    friend class BucketMaxMeasureLiftingStrategy2;
     friend class OldMaxMeasureLiftingStrategy;
 
+    // Allow the concurrent implementation to lift vertices itself:
+    friend class ConcurrentSPM;
+
 protected:
     const ParityGame       &game_;     //!< the game being solved
     const int              p_;         //!< the player to solve for
@@ -274,6 +465,8 @@ protected:
     verti                  *M_;        //!< bounds on the SPM vector components
     ParityGame::Strategy   strategy_;  //!< current strategy
     bool                   *dirty_;    //!< marks unstable vertices
+    std::vector<verti>     liberties_; //!< non-top successors (player's own)
+    std::vector<verti>     top_queue_; //!< vertices set to top, to attract to
 };
 
 /*! \ingroup SmallProgressMeasures
@@ -303,6 +496,139 @@ protected:
     verti *spm_;  //!< array storing the SPM vector data
 };
 
+/*! \ingroup SmallProgressMeasures
+
+    A small progress measures implementation that stores progress measure
+    vectors "sparsely": each vertex `v` takes only len(v) elements (or one, if
+    len(v) is zero, to be able to represent top) instead of len() elements,
+    which saves memory when most vertices have less than the maximum priority.
+
+    Vectors are stored consecutively in a single array. As in CompressedGraph,
+    vertices are grouped into blocks, and the offset of each block is stored
+    in full while offsets of vertices are stored relative to their block.
+
+    The rest of the algorithm assumes that the components of a vector beyond
+    len(v) are zero, so vec() returns vectors shorter than len() zero-padded
+    in one of `vec_buffers` internal buffers which are reused in turn: a
+    pointer returned by vec() remains valid only until vec() has been called
+    `vec_buffers` more times.
+*/
+class SparseSPM : public SmallProgressMeasures
+{
+public:
+    /*! Number of buffers used to return padded vectors from vec(), which
+        must be at least the number of vectors get_ext_succ() compares at
+        once. */
+    static const int vec_buffers = ext_batch_size;
+
+    SparseSPM(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats = 0,
+        const verti *vertex_map = 0, verti vertex_map_size = 0 );
+    ~SparseSPM();
+
+    const verti *vec(verti v) const;
+    void set_vec(verti v, const verti src[], bool carry);
+    void set_vec_to_top(verti v);
+
+protected:
+    int vector_cmp(verti v, verti w, int N) const;
+
+    /*! Returns a pointer to the stored (unpadded) vector of vertex `v`. */
+    verti *stored_vec(verti v) const
+    {
+        return &spm_[block_[v >> block_bits_] + offset_[v]];
+    }
+
+private:
+    SparseSPM(const SparseSPM &);
+    SparseSPM &operator=(const SparseSPM &);
+
+protected:
+    int                 block_bits_;    //!< log2 of vertices per block
+    verti               *spm_;          //!< array storing the SPM vector data
+    size_t              *block_;        //!< offsets of blocks in spm_
+    compat_uint16_t     *offset_;       //!< offsets of vertices in blocks
+
+    mutable std::vector<verti> vec_buf_;    //!< buffers for vec()
+    mutable int vec_buf_next_;              //!< next buffer to use
+};
+
+
+/*! \ingroup SmallProgressMeasures
+
+    A small progress measures implementation that stores each distinct
+    progress measure vector only once, in a reference-counted pool, while
+    vertices refer to their vectors by 32-bit handles. This saves memory when
+    many vertices have equal vectors (which is typical, since all vectors start
+    at zero and lifting copies vectors from successors), at the cost of a hash
+    table lookup for each assignment. Vertices with equal handles compare equal
+    without looking at their vectors.
+
+    Pooled vectors have len() components (zero beyond len(v)) and are stored
+    in chunks that are never moved, so pointers returned by vec() stay valid,
+    though a slot is reused once no vertex refers to its vector anymore.
+*/
+class PoolSPM : public SmallProgressMeasures
+{
+public:
+    PoolSPM(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats = 0,
+        const verti *vertex_map = 0, verti vertex_map_size = 0 );
+    ~PoolSPM();
+
+    const verti *vec(verti v) const { return pool_vec(handle_[v]); }
+    void set_vec(verti v, const verti src[], bool carry);
+    void set_vec_to_top(verti v);
+
+protected:
+    int vector_cmp(verti v, verti w, int N) const;
+
+private:
+    typedef compat_uint32_t handle_t;
+    static const handle_t NO_HANDLE = (handle_t)-1;
+
+    //! log2 of the number of vectors per chunk of the pool
+    static const int chunk_bits = 10;
+
+    //! Returns the pooled vector with handle `h`.
+    verti *pool_vec(handle_t h) const
+    {
+        return &chunks_[h >> chunk_bits]
+                       [(size_t)len_*(h & ((1 << chunk_bits) - 1))];
+    }
+
+    //! Returns the hash value of the given vector of len() components.
+    compat_uint32_t hash(const verti vec[]) const;
+
+    /*! Returns a handle to a pooled copy of the given vector, adding it to
+        the pool if necessary, and increments its reference count. */
+    handle_t intern(const verti vec[]);
+
+    /*! Decrements the reference count of the given handle, and removes its
+        vector from the pool if it drops to zero. */
+    void release(handle_t h);
+
+    //! Doubles the size of the hash table.
+    void grow_buckets();
+
+private:
+    PoolSPM(const PoolSPM &);
+    PoolSPM &operator=(const PoolSPM &);
+
+private:
+    handle_t                        *handle_;   //!< vector handle per vertex
+    std::vector<verti*>             chunks_;    //!< pooled vector data
+    std::vector<verti>              refs_;      //!< reference counts
+    std::vector<compat_uint32_t>    hash_;      //!< hash values
+    std::vector<handle_t>           next_;      //!< hash chain/free list links
+    std::vector<handle_t>           buckets_;   //!< hash table
+    handle_t                        free_;      //!< first unused handle
+    verti                           size_;      //!< number of pooled vectors
+    verti                           max_size_;  //!< maximum of size_
+    std::vector<verti>              tmp_;       //!< vector to be interned
+};
 
 /*! \ingroup SmallProgressMeasures
 
@@ -333,12 +659,29 @@ protected:
     };
 
 public:
+    /*! Storage formats for progress measure vectors. */
+    enum Storage
+    {
+        STORAGE_DENSE   = 0,    //!< DenseSPM or FixedDenseSPM
+        STORAGE_SPARSE  = 1,    //!< SparseSPM
+        STORAGE_POOL    = 2     //!< PoolSPM
+    };
+
+    /*! Constructs a solver for `game` using lifting strategies created by
+        `lsf`, storing progress measures in the given `storage` format.
+
+        When `alternate` is true, Friedmann's two-sided approach is used. If
+        `parallel` is true as well (and thread support is compiled in), the
+        normal game and its dual are then lifted concurrently by two threads.
+    */
     SmallProgressMeasuresSolver( const ParityGame &game,
                                  LiftingStrategyFactory *lsf,
                                  bool alternate = false,
                                  LiftingStatistics *stats = 0,
                                  const verti *vertex_map = 0,
-                                 verti vertex_map_size = 0 );
+                                 verti vertex_map_size = 0,
+                                 Storage storage = STORAGE_DENSE,
+                                 bool parallel = false );
     virtual ~SmallProgressMeasuresSolver();
 
     ParityGame::Strategy solve();
@@ -349,6 +692,25 @@ public:
         game is easier to solve than its dual. */
     virtual ParityGame::Strategy solve_normal();
 
+    /*! Enables checkpointing: the progress measures being lifted are written
+        to the file at `path` every `interval` seconds, and when solving is
+        aborted. If `resume` is true, solving continues from the progress
+        measures in `path`, if that file was written for the same game.
+
+        Only one solver should use a given file at a time; when a game is
+        split into several subgames, only the subgame being solved when the
+        checkpoint was written is resumed. */
+    void set_checkpoint(const std::string &path, double interval, bool resume);
+
+    /*! Enables warm starting: if `load_path` is non-empty, progress measures
+        are seeded from that file (see SmallProgressMeasures::warm_start()),
+        and if `save_path` is non-empty, the final progress measures are
+        written to that file. Since the normal algorithm solves Odd's half of
+        the game as a separate subgame, only Even's measures are used then.
+        Games solved with a vertex map (i.e. subgames) are never seeded. */
+    void set_warm_start( const std::string &load_path,
+                         const std::string &save_path );
+
     /*! Solves the game using Friedmann's alternate strategy. This allocates
         solving algorithms for both the normal game and its dual at once, and
         alternates working on each, exchanging information about solved vertices
@@ -364,6 +726,81 @@ public:
         which does more general preprocessing. */
     static void preprocess_game(ParityGame &game);
 
+    /*! Creates a progress measures instance to solve `game` for `player`.
+        For dense storage, this chooses a FixedDenseSPM instantiation for the
+        length of the progress measure vectors (with the narrowest component
+        type that fits the vector space) if there is one, or a DenseSPM
+        otherwise. */
+    static SmallProgressMeasures *create_spm(
+        const ParityGame &game, ParityGame::Player player,
+        LiftingStatistics *stats = 0,
+        const verti *vertex_map = 0, verti vertex_map_size = 0,
+        Storage storage = STORAGE_DENSE );
+
+protected:
+#ifdef WITH_THREADS
+    /*! Single-producer, single-consumer queue of vertices solved in one game,
+        which are published to the thread that lifts the other game. Since
+        every vertex is pushed at most once, the queue never wraps around. */
+    struct SolvedQueue
+    {
+        std::vector<verti>  vertices;   //!< pushed vertices
+        size_t              written;    //!< number of vertices pushed
+        volatile size_t     published;  //!< number of vertices published
+
+        SolvedQueue() : written(0), published(0) { }
+
+        //! Pushes `v`; called by the producer only.
+        void push(verti v) { vertices[written++] = v; }
+
+        //! Makes pushed vertices available to the consumer.
+        void flush()
+        {
+            __atomic_store_n(&published, written, __ATOMIC_RELEASE);
+        }
+
+        //! Returns the number of vertices available to the consumer.
+        size_t available() const
+        {
+            return __atomic_load_n(&published, __ATOMIC_ACQUIRE);
+        }
+    };
+
+    /*! Solves the game using Friedmann's two-sided approach, lifting the
+        normal game and its dual concurrently in two threads, using lifting
+        strategies of class `LS` (which selects the SPM version). Each thread
+        periodically publishes the vertices it has found to be won by its
+        player, which the other thread sets to top in its own game. */
+    template<class LS> ParityGame::Strategy solve_alternate_concurrently();
+
+    /*! Lifts `spm` (solving for `player`) until it is stable, taking solved
+        vertices from `in` and publishing vertices won by `player` to `out`.
+        Returns false if solving is aborted. */
+    template<class LS> bool solve_side( SmallProgressMeasures &spm,
+        ParityGame::Player player, SolvedQueue &in, SolvedQueue &out );
+#endif
+
+    /*! Writes `stage` and the progress measures in `spm[0:count)` to the
+        checkpoint file, if checkpointing is enabled and the checkpoint
+        interval has passed since the last checkpoint (or `force` is set). */
+    void checkpoint( int stage, const SmallProgressMeasures * const spm[],
+                     int count, bool force = false );
+
+    /*! Loads the checkpoint file into resume_spm_ and resume_stage_ if
+        resuming was requested and the file matches the game. */
+    void load_checkpoint();
+
+    /*! Restores the `i`-th progress measures saved in the checkpoint being
+        resumed from into `spm`, and returns whether this succeeded. */
+    bool restore(int i, SmallProgressMeasures &spm);
+
+    /*! Seeds `spm` from the warm start file, if one was given. */
+    void warm_start(SmallProgressMeasures &spm);
+
+    /*! Writes the progress measures in `spm[0:count)` to the file given by
+        set_warm_start(), if any. */
+    void save_measures(const SmallProgressMeasures * const spm[], int count);
+
 private:
     SmallProgressMeasuresSolver(const SmallProgressMeasuresSolver&);
     SmallProgressMeasuresSolver &operator=(const SmallProgressMeasuresSolver&);
@@ -374,6 +811,18 @@ protected:
     LiftingStatistics *stats_;      //!< object to record lifting statistics
     const verti *vmap_;             //!< current vertex map
     const verti vmap_size_;         //!< size of vertex map
+    const Storage storage_;         //!< progress measure storage format
+    const bool parallel_;           //!< whether to lift both games at once
+
+    std::string checkpoint_path_;   //!< checkpoint file (empty if disabled)
+    double checkpoint_interval_;    //!< seconds between checkpoints
+    double last_checkpoint_;        //!< time of the last checkpoint
+    bool resume_;                   //!< whether to resume from checkpoint
+    int resume_stage_;              //!< stage to resume, or -1 if none
+    std::vector<std::string> resume_spm_;  //!< progress measures to resume
+
+    std::string warm_start_path_;   //!< measures to seed (empty if none)
+    std::string save_measures_path_;  //!< file to write final measures to
 };
 
 /*! \ingroup SmallProgressMeasures
@@ -390,7 +839,9 @@ public:
                                   bool alternate = false,
                                   LiftingStatistics *stats = 0,
                                   const verti *vertex_map = 0,
-                                  verti vertex_map_size = 0 );
+                                  verti vertex_map_size = 0,
+                                  Storage storage = STORAGE_DENSE,
+                                  bool parallel = false );
     ~SmallProgressMeasuresSolver2();
 
     ParityGame::Strategy solve_normal();
@@ -408,18 +859,37 @@ class SmallProgressMeasuresSolverFactory : public ParityGameSolverFactory
 {
 public:
     SmallProgressMeasuresSolverFactory( LiftingStrategyFactory *lsf,
-        int version = 1, bool alt = false, LiftingStatistics *stats = 0 );
+        int version = 1, bool alt = false, LiftingStatistics *stats = 0,
+        SmallProgressMeasuresSolver::Storage storage
+            = SmallProgressMeasuresSolver::STORAGE_DENSE,
+        bool parallel = false );
     ~SmallProgressMeasuresSolverFactory();
 
     ParityGameSolver *create( const ParityGame &game,
                               const verti *vertex_map,
                               verti vertex_map_size );
 
+    /*! Enables checkpointing in created solvers.
+        \see SmallProgressMeasuresSolver::set_checkpoint() */
+    void set_checkpoint(const std::string &path, double interval, bool resume);
+
+    /*! Enables warm starting in created solvers.
+        \see SmallProgressMeasuresSolver::set_warm_start() */
+    void set_warm_start( const std::string &load_path,
+                         const std::string &save_path );
+
 private:
     LiftingStrategyFactory  *lsf_;
     int                     version_;
     bool                    alt_;
     LiftingStatistics       *stats_;
+    SmallProgressMeasuresSolver::Storage storage_;
+    bool                    parallel_;
+    std::string             checkpoint_path_;
+    double                  checkpoint_interval_;
+    bool                    resume_;
+    std::string             warm_start_path_;
+    std::string             save_measures_path_;
 };
 
 #include "SmallProgressMeasures_impl.h"
@@ -12,24 +12,65 @@
 #include <vector>
 #include <deque>
 
-inline int SmallProgressMeasures::vector_cmp(verti v, verti w, int N) const
+inline LiftingStatistics::Counters *LiftingStatistics::own_counters()
 {
-    return vector_cmp(vec(v), vec(w), N);
+#ifdef WITH_THREADS
+    int i = thread_index_;
+    if (i < 0)
+    {
+        i = __atomic_fetch_add(&num_thread_indices_, 1, __ATOMIC_RELAXED);
+        thread_index_ = i;
+    }
+    return i < max_threads ? &counters_[i] : NULL;
+#else
+    return &counters_[0];
+#endif
 }
 
-inline int SmallProgressMeasures::vector_cmp( const verti vec1[],
-                                              const verti vec2[], int N ) const
+inline void LiftingStatistics::record_vertex(verti v, bool success)
 {
-    if (is_top(vec1)) return is_top(vec2) ? 0 : +1;  // v is top
-    if (is_top(vec2)) return -1;                     // w is top, but v isn't
+    assert(v < vertex_stats_.size());
+    VertexCounts &vc = vertex_stats_[v];
+#ifdef WITH_THREADS
+    __atomic_fetch_add(&vc.attempted, 1, __ATOMIC_RELAXED);
+    if (success) __atomic_fetch_add(&vc.succeeded, 1, __ATOMIC_RELAXED);
+#else
+    ++vc.attempted;
+    vc.succeeded += success;
+#endif
+}
 
-    for (int n = 0; n < N; ++n)
+inline void LiftingStatistics::record_lift(verti v, bool success)
+{
+    Counters *c = own_counters();
+    if (c == NULL)
+    {
+        record_lift_shared(v, success);
+        return;
+    }
+    ++c->attempted;
+    c->succeeded += success;
+    if (c->attempted >= c->next_check) check_max_lifts(*c);
+#if SPM_STATS == SPM_STATS_FULL
+    if (v != NO_VERTEX) record_vertex(v, success);
+#elif SPM_STATS == SPM_STATS_SAMPLED
+    if (c->attempted >= c->next_sample && v != NO_VERTEX)
     {
-        if (vec1[n] < vec2[n]) return -1;
-        if (vec1[n] > vec2[n]) return +1;
+        sample(*c, v, success);
     }
+#endif
+}
 
-    return 0;
+inline int SmallProgressMeasures::vector_cmp(verti v, verti w, int N) const
+{
+    return vector_cmp(vec(v), vec(w), N);
+}
+
+inline int SmallProgressMeasures::vector_cmp( const verti vec1[],
+                                              const verti vec2[], int N ) const
+{
+    return N < ext_kernel_min_len ? vector_cmp_scalar(vec1, vec2, N)
+                                  : vector_cmp_best(vec1, vec2, N);
 }
 
 inline verti SmallProgressMeasures::get_ext_succ(verti v, bool take_max) const
@@ -39,14 +80,43 @@ inline verti SmallProgressMeasures::get_ext_succ(verti v, bool take_max) const
 
     assert(it < end);  /* assume we have at least one successor */
 
-    int N = len(v);
     verti res = *it++;
-    for ( ; it != end; ++it)
+    if (it == end) return res;
+
+    const int N = len(v);
+    if (N < ext_kernel_min_len)
     {
-        int d = vector_cmp(*it, res, N);
-        if (take_max ? d > 0 : d < 0) res = *it;
+        // Short vectors are compared inline:
+        for ( ; it != end; ++it)
+        {
+            int d = vector_cmp(*it, res, N);
+            if (take_max ? d > 0 : d < 0) res = *it;
+        }
+        return res;
+    }
+
+    /* Successor vectors are collected in batches, which are passed to the
+       extremum kernel together with the extreme vector found so far (which
+       is kept first, so ties are resolved in favour of earlier successors).
+       Its vector is fetched again for each batch, because vec() may return
+       temporary buffers that are only valid for a limited number of calls
+       (see FixedDenseSPM). */
+    const verti *vecs[ext_batch_size];
+    verti succs[ext_batch_size];
+    succs[0] = res;
+    for (;;)
+    {
+        vecs[0] = vec(succs[0]);
+        int n = 1;
+        for ( ; n < ext_batch_size && it != end; ++n, ++it)
+        {
+            succs[n] = *it;
+            vecs[n]  = vec(*it);
+        }
+        int i = vector_ext_best(vecs, n, N, take_max);
+        if (it == end) return succs[i];
+        succs[0] = succs[i];
     }
-    return res;
 }
 
 template<class OutputIterator>
@@ -157,4 +227,5 @@ void SmallProgressMeasures::set_top(verti v)
     set_vec_to_top(v);
     int prio = game_.priority(v);
     if (prio%2 != p_) decr_M(prio/2);
+    top_queue_.push_back(v);
 }
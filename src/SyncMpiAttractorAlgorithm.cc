@@ -104,13 +104,13 @@ void SyncMpiAttractorImpl::exchange_queues(std::deque<verti> &next_queue)
                     }
                     if (found)
                     {
-                        int val = (int)part.global(*it);
-                        MPI::COMM_WORLD.Send(&val, 1, MPI_INT, j, 0);
+                        verti val = part.global(*it);
+                        MPI::COMM_WORLD.Send(&val, 1, MPI_VERTI, j, 0);
                         //debug("sending %d to %d", val, j);
                     }
                 }
-                int val = -1;
-                MPI::COMM_WORLD.Send(&val, 1, MPI_INT, j, 0);
+                verti val = NO_VERTEX;
+                MPI::COMM_WORLD.Send(&val, 1, MPI_VERTI, j, 0);
             }
 
             if (i != mpi_rank && j == mpi_rank)
@@ -118,11 +118,11 @@ void SyncMpiAttractorImpl::exchange_queues(std::deque<verti> &next_queue)
                 // Receive relevant vertices from i'th process
                 for (;;)
                 {
-                    int val = -1;
-                    MPI::COMM_WORLD.Recv(&val, 1, MPI_INT, i, 0);
-                    if (val == -1) break;
+                    verti val = NO_VERTEX;
+                    MPI::COMM_WORLD.Recv(&val, 1, MPI_VERTI, i, 0);
+                    if (val == NO_VERTEX) break;
                     //debug("received %d from %d", val, i);
-                    const verti v = part.local((verti)val);
+                    const verti v = part.local(val);
                     assert(!attr.count(v));
                     attr.insert(v);
                     next_queue.push_back(v);
@@ -11,6 +11,8 @@
 #define ATTRACTOR_H_INCLUDED
 
 #include "ParityGame.h"
+#include <algorithm>
+#include <vector>
 
 /*! Helper function: returns whether all elements in range [begin:end) are
     elements of `set`.  Note that both the range and the set elements must be
@@ -32,6 +34,204 @@ template<class SetT, class DequeT, class StrategyT>
 void make_attractor_set( const ParityGame &game, ParityGame::Player player,
     SetT &vertices, DequeT &todo, StrategyT &strategy );
 
+/*! Reusable workspace for attractor set computations.
+
+    Computing an attractor set requires per-vertex bookkeeping (the number of
+    successors of each opponent-controlled vertex that are not yet in the
+    attractor set). Instead of allocating and initializing O(V) memory for
+    every computation, a context keeps its arrays between computations and
+    tags entries with a generation number, so that clearing them takes O(1)
+    time. Liberties are initialized lazily, when a vertex is first reached,
+    so the cost of a computation is proportional to the number of edges it
+    actually traverses.
+
+    The context also provides a vertex set (with the same generation-stamped
+    representation) that can be used as the attractor set itself.
+
+    A single context can be shared between subsequent (but not concurrent)
+    computations on different games, as long as it has been resized to fit
+    the largest game. */
+class AttractorContext
+{
+public:
+    typedef compat_uint16_t stamp_t;
+
+    /*! Constructs a context for games with up to `V` vertices. */
+    explicit AttractorContext(verti V = 0)
+        : member_gen_(1), attr_gen_(1), size_(0)
+    {
+        resize(V);
+    }
+
+    /*! Ensures the context can be used for games with up to `V` vertices. */
+    void resize(verti V)
+    {
+        if (V <= member_.size()) return;
+        member_.resize(V, 0);
+        stamp_.resize(V, 0);
+        liberties_.resize(V, 0);
+    }
+
+    //!\name Vertex set interface
+    //!@{
+
+    /*! Removes all vertices from the set in (amortized) constant time. */
+    void clear()
+    {
+        size_ = 0;
+        if (++member_gen_ == 0)
+        {
+            std::fill(member_.begin(), member_.end(), 0);
+            member_gen_ = 1;
+        }
+    }
+
+    /*! Returns the number of vertices in the set. */
+    verti size() const { return size_; }
+
+    /*! Returns whether the set is empty. */
+    bool empty() const { return size_ == 0; }
+
+    /*! Returns 1 if `v` is in the set, or 0 otherwise. */
+    verti count(verti v) const { return member_[v] == member_gen_; }
+
+    /*! Inserts `v` into the set. */
+    void insert(verti v)
+    {
+        if (member_[v] != member_gen_) member_[v] = member_gen_, ++size_;
+    }
+
+    //!@}
+
+    /*! Extends `vertices` to its attractor set for `player` in the subgame
+        of `game` induced by the vertices `v` with `alive(v)`, using edges
+        from `graph` (which must have the same vertices as the game graph),
+        and updates `strategy` for all vertices added.
+
+        `todo` must initially contain all vertices in `vertices` whose
+        predecessors have not been considered yet. If `graph` stores successor
+        edges, `vertices` may contain additional vertices (for example, from
+        earlier computations) whose predecessors need not be reconsidered.
+        Otherwise, out-degrees must be computed from predecessor edges, which
+        takes O(V + E) time, and `todo` must contain all of `vertices`. */
+    template< class GraphT, class SetT, class DequeT, class StrategyT,
+              class AliveT >
+    void make_attractor_set( const ParityGame &game, const GraphT &graph,
+                             ParityGame::Player player, SetT &vertices,
+                             DequeT &todo, StrategyT &strategy,
+                             AliveT alive );
+
+    /*! Computes an attractor set in the whole game; see above. */
+    template<class GraphT, class SetT, class DequeT, class StrategyT>
+    void make_attractor_set( const ParityGame &game, const GraphT &graph,
+                             ParityGame::Player player, SetT &vertices,
+                             DequeT &todo, StrategyT &strategy );
+
+private:
+    AttractorContext(const AttractorContext &);
+    AttractorContext &operator=(const AttractorContext &);
+
+    /*! Set membership: member_[v] == member_gen_ iff. v is in the set. */
+    std::vector<stamp_t> member_;
+
+    /*! Attractor computation stamps: stamp_[v] == attr_gen_ iff. liberties_[v]
+        has been initialized in the current computation (for vertices outside
+        the attractor set) or v is still queued (for vertices in the set). */
+    std::vector<stamp_t> stamp_;
+
+    /*! Number of successors that may still be added to the attractor set. */
+    std::vector<verti> liberties_;
+
+    stamp_t member_gen_;    //!< current generation of the set
+    stamp_t attr_gen_;      //!< current attractor computation
+    verti size_;            //!< number of vertices in the set
+};
+
+#ifdef WITH_THREADS
+/*! Reusable workspace for attractor set computations using multiple threads.
+
+    The attractor set is computed level by level: the predecessors of all
+    vertices in the current frontier are examined in parallel, and each thread
+    collects the vertices it attracts in a private buffer; together, these
+    buffers form the next frontier. A player-controlled vertex is claimed by
+    the first thread that reaches it, and an opponent-controlled vertex by the
+    thread that decrements its number of liberties to zero, so every vertex is
+    attracted exactly once and every edge is traversed a constant number of
+    times. As with AttractorContext, liberties are initialized lazily.
+
+    The attractor set itself is only read by worker threads; vertices are
+    inserted by the calling thread between levels, so it need not be
+    thread-safe. */
+class ParallelAttractorContext
+{
+public:
+    typedef compat_uint16_t stamp_t;
+    typedef compat_uint32_t level_t;
+
+    /*! Constructs a context for games with up to `V` vertices. Levels with
+        fewer than `min_parallel` vertices are processed sequentially. */
+    explicit ParallelAttractorContext(verti V = 0, verti min_parallel = 1024)
+        : min_parallel_(min_parallel), attr_gen_(0), level_gen_(0)
+    {
+        resize(V);
+    }
+
+    /*! Ensures the context can be used for games with up to `V` vertices. */
+    void resize(verti V)
+    {
+        if (V <= stamp_.size()) return;
+        stamp_.resize(V, 0);
+        level_.resize(V, 0);
+        liberties_.resize(V, 0);
+    }
+
+    /*! Extends `vertices` to its attractor set for `player` in `game`, and
+        updates `strategy` for all vertices added. The game graph must store
+        both successor and predecessor edges.
+
+        `frontier` must initially contain all vertices in `vertices` whose
+        predecessors have not been considered yet; other vertices in
+        `vertices` are not reconsidered. It is empty on return. */
+    template<class SetT, class StrategyT>
+    void make_attractor_set( const ParityGame &game, ParityGame::Player player,
+                             SetT &vertices, std::vector<verti> &frontier,
+                             StrategyT &strategy );
+
+private:
+    ParallelAttractorContext(const ParallelAttractorContext &);
+    ParallelAttractorContext &operator=(const ParallelAttractorContext &);
+
+    /*! Initializes liberties_[v] (if no other thread has done so in the
+        current computation) to the number of successors of `v` outside
+        `vertices` or in the frontier at level `level`. */
+    template<class SetT>
+    void init_liberties( const StaticGraph &graph, const SetT &vertices,
+                         verti v, stamp_t gen, level_t level );
+
+    //! Stamp value indicating that liberties are being initialized.
+    static const stamp_t busy = (stamp_t)-1;
+
+    /*! Attractor computation stamps: stamp_[v] == attr_gen_ iff. liberties_[v]
+        has been initialized in the current computation. */
+    std::vector<stamp_t> stamp_;
+
+    /*! Frontier levels: level_[v] == level_gen_ iff. v is in the frontier
+        currently being processed, or level_gen_ + 1 if it has been attracted
+        into the next frontier. */
+    std::vector<level_t> level_;
+
+    /*! Number of successors that may still be added to the attractor set. */
+    std::vector<verti> liberties_;
+
+    /*! Vertices attracted by each thread in the current level. */
+    std::vector<std::vector<verti> > buffers_;
+
+    const verti min_parallel_;  //!< minimum frontier size to use threads
+    stamp_t attr_gen_;          //!< current attractor computation
+    level_t level_gen_;         //!< current frontier level
+};
+#endif /* def WITH_THREADS */
+
 #include "attractor_impl.h"
 
 #endif /* ndef ATTRACTOR_H_INCLUDED */
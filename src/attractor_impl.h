@@ -10,6 +10,10 @@
 #include "attractor.h"
 #include <queue>
 
+#ifdef WITH_THREADS
+#include <omp.h>
+#endif
+
 template<class ForwardIterator, class SetT>
 bool is_subset_of(ForwardIterator it, ForwardIterator end, const SetT &set)
 {
@@ -76,65 +80,261 @@ void make_attractor_set_2( const ParityGame &game, ParityGame::Player player,
     return make_attractor_set_2(game, player, vertices, todo, strategy);
 }
 
-// Experimental, alternate implementation.
-// Only uses predecessor edges but uses O(|V|) extra space and O(|E|) extra time.
-// TODO: document!
+// Alternate implementation, using an AttractorContext.
+// Only uses predecessor edges if the graph does not store successors, but then
+// takes O(|E|) extra time, and `todo` must contain all of `vertices`.
 template<class SetT, class DequeT, class StrategyT>
 void make_attractor_set_2( const ParityGame &game, ParityGame::Player player,
     SetT &vertices, DequeT &todo, StrategyT &strategy )
 {
-    const StaticGraph &graph = game.graph();
+    AttractorContext context(game.graph().V());
+    context.make_attractor_set( game, game.graph(), player, vertices, todo,
+                                strategy );
+}
+
+/*! Predicate that accepts all vertices of a game. */
+struct AllVertices
+{
+    bool operator()(verti) const { return true; }
+};
+
+template<class GraphT, class SetT, class DequeT, class StrategyT>
+void AttractorContext::make_attractor_set( const ParityGame &game,
+    const GraphT &graph, ParityGame::Player player, SetT &vertices,
+    DequeT &todo, StrategyT &strategy )
+{
+    make_attractor_set( game, graph, player, vertices, todo, strategy,
+                        AllVertices() );
+}
 
-    // Initialize liberties so that liberties[v] == outdegree of v
-    std::vector<verti> liberties(graph.V(), 0);
-    for (verti v = 0; v < graph.V(); ++v)
+template< class GraphT, class SetT, class DequeT, class StrategyT,
+          class AliveT >
+void AttractorContext::make_attractor_set( const ParityGame &game,
+    const GraphT &graph, ParityGame::Player player, SetT &vertices,
+    DequeT &todo, StrategyT &strategy, AliveT alive )
+{
+    typedef typename GraphT::const_iterator const_iterator;
+
+    assert(graph.V() == game.graph().V());
+    resize(graph.V());
+
+    // Start a new computation, which invalidates all liberties:
+    if (++attr_gen_ == 0)
     {
-        for (StaticGraph::const_iterator it = graph.pred_begin(v);
-             it != graph.pred_end(v); ++it) ++liberties[*it];
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        attr_gen_ = 1;
     }
+    const stamp_t gen = attr_gen_;
 
-    // Mark initial set as included:
-    for (typename SetT::const_iterator it = vertices.begin();
-         it != vertices.end(); ++it)
+    if (!(graph.edge_dir() & StaticGraph::EDGE_SUCCESSOR))
     {
-        liberties[*it] = 0;
+        // Initialize liberties so that liberties[v] == outdegree of v
+        for (verti v = 0; v < graph.V(); ++v)
+        {
+            stamp_[v] = gen;
+            liberties_[v] = 0;
+        }
+        for (verti w = 0; w < graph.V(); ++w)
+        {
+            if (!alive(w)) continue;
+            for (const_iterator it = graph.pred_begin(w);
+                 it != graph.pred_end(w); ++it) ++liberties_[*it];
+        }
     }
 
+    // Mark queued vertices, whose predecessors have yet to be updated:
+    for (typename DequeT::const_iterator it = todo.begin();
+         it != todo.end(); ++it) stamp_[*it] = gen;
+
     // Process queue:
     while (!todo.empty())
     {
         const verti w = todo.front();
         todo.pop_front();
+        stamp_[w] = 0;
 
         // Check all predecessors v of w:
-        for (StaticGraph::const_iterator it = graph.pred_begin(w);
+        for (const_iterator it = graph.pred_begin(w);
              it != graph.pred_end(w); ++it)
         {
             const verti v = *it;
 
             // Skip predecessors that are already in the attractor set:
-            if (liberties[v] == 0) continue;
+            if (!alive(v) || vertices.count(v)) continue;
 
             if (game.player(v) == player)
             {
                 // Store strategy for player-controlled vertex:
                 strategy[v] = w;
-                liberties[v] = 0;
             }
             else  // opponent controls vertex
-            if (--liberties[v] == 0)
             {
+                if (stamp_[v] != gen)
+                {
+                    // Count successors that may still lead to decrements:
+                    // those outside the attractor set or still queued, and
+                    // all edges to `w` (one of which is being processed now).
+                    verti n = 0;
+                    for (const_iterator jt = graph.succ_begin(v);
+                         jt != graph.succ_end(v); ++jt)
+                    {
+                        const verti u = *jt;
+                        if ( u == w || ( alive(u) &&
+                                         ( !vertices.count(u) ||
+                                           stamp_[u] == gen ) ) )
+                        {
+                            ++n;
+                        }
+                    }
+                    stamp_[v] = gen;
+                    liberties_[v] = n;
+                }
+                if (--liberties_[v] != 0) continue;  // not in the set yet!
+
                 // Store strategy for opponent-controlled vertex:
                 strategy[v] = NO_VERTEX;
             }
-            else
-            {
-                continue;  // not in the attractor set yet!
-            }
 
             // Add vertex v to the attractor set:
             vertices.insert(v);
+            stamp_[v] = gen;
             todo.push_back(v);
         }
     }
 }
+
+#ifdef WITH_THREADS
+template<class SetT>
+void ParallelAttractorContext::init_liberties( const StaticGraph &graph,
+    const SetT &vertices, verti v, stamp_t gen, level_t level )
+{
+    stamp_t s = __atomic_load_n(&stamp_[v], __ATOMIC_ACQUIRE);
+    while (s != gen)
+    {
+        if ( s != busy &&
+             __atomic_compare_exchange_n( &stamp_[v], &s, busy, false,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE ) )
+        {
+            // Count successors that may still lead to decrements: those
+            // outside the attractor set, or in the frontier being processed.
+            // Neither changes while the current level is being processed.
+            verti n = 0;
+            for ( StaticGraph::const_iterator it = graph.succ_begin(v);
+                  it != graph.succ_end(v); ++it )
+            {
+                const verti u = *it;
+                if (!vertices.count(u) || level_[u] == level) ++n;
+            }
+            liberties_[v] = n;
+            __atomic_store_n(&stamp_[v], gen, __ATOMIC_RELEASE);
+            return;
+        }
+
+        // Another thread is initializing liberties; wait for it to finish.
+        s = __atomic_load_n(&stamp_[v], __ATOMIC_ACQUIRE);
+    }
+}
+
+template<class SetT, class StrategyT>
+void ParallelAttractorContext::make_attractor_set( const ParityGame &game,
+    ParityGame::Player player, SetT &vertices, std::vector<verti> &frontier,
+    StrategyT &strategy )
+{
+    const StaticGraph &graph = game.graph();
+    assert(graph.edge_dir() == StaticGraph::EDGE_BIDIRECTIONAL);
+    resize(graph.V());
+    buffers_.resize(omp_get_max_threads());
+
+    // Start a new computation, which invalidates all liberties:
+    if (++attr_gen_ == busy)
+    {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        attr_gen_ = 1;
+    }
+    const stamp_t gen = attr_gen_;
+
+    // Mark the initial frontier:
+    if (++level_gen_ == (level_t)-1)
+    {
+        std::fill(level_.begin(), level_.end(), 0);
+        level_gen_ = 1;
+    }
+    for (std::vector<verti>::const_iterator it = frontier.begin();
+         it != frontier.end(); ++it) level_[*it] = level_gen_;
+
+    while (!frontier.empty())
+    {
+        const level_t level = level_gen_, next = level + 1;
+        const long size = (long)frontier.size();
+
+        #pragma omp parallel if (size >= (long)min_parallel_)
+        {
+            std::vector<verti> &attracted = buffers_[omp_get_thread_num()];
+
+            #pragma omp for schedule(dynamic, 64)
+            for (long i = 0; i < size; ++i)
+            {
+                const verti w = frontier[i];
+
+                // Check all predecessors v of w:
+                for ( StaticGraph::const_iterator it = graph.pred_begin(w);
+                      it != graph.pred_end(w); ++it )
+                {
+                    const verti v = *it;
+
+                    // Skip predecessors that are already in the attractor set:
+                    if (vertices.count(v)) continue;
+
+                    if (game.player(v) == player)
+                    {
+                        // Claim vertex, unless another thread already did:
+                        level_t l = __atomic_load_n( &level_[v],
+                                                     __ATOMIC_RELAXED );
+                        if ( l == next ||
+                             !__atomic_compare_exchange_n( &level_[v], &l,
+                                  next, false, __ATOMIC_RELAXED,
+                                  __ATOMIC_RELAXED ) ) continue;
+
+                        // Store strategy for player-controlled vertex:
+                        strategy[v] = w;
+                    }
+                    else  // opponent controls vertex
+                    {
+                        init_liberties(graph, vertices, v, gen, level);
+                        if (__atomic_sub_fetch( &liberties_[v], 1,
+                                                __ATOMIC_ACQ_REL ) != 0)
+                        {
+                            continue;  // not in the set yet!
+                        }
+                        __atomic_store_n(&level_[v], next, __ATOMIC_RELAXED);
+
+                        // Store strategy for opponent-controlled vertex:
+                        strategy[v] = NO_VERTEX;
+                    }
+                    attracted.push_back(v);
+                }
+            }
+        }
+
+        // Add attracted vertices to the set, forming the next frontier:
+        frontier.clear();
+        for (size_t t = 0; t < buffers_.size(); ++t)
+        {
+            std::vector<verti> &attracted = buffers_[t];
+            for (std::vector<verti>::const_iterator it = attracted.begin();
+                 it != attracted.end(); ++it) vertices.insert(*it);
+            frontier.insert(frontier.end(), attracted.begin(), attracted.end());
+            attracted.clear();
+        }
+
+        // Advance to the next level (which has already been marked):
+        if ((level_gen_ = next) == (level_t)-1)
+        {
+            std::fill(level_.begin(), level_.end(), 0);
+            level_gen_ = 1;
+            for (std::vector<verti>::const_iterator it = frontier.begin();
+                 it != frontier.end(); ++it) level_[*it] = level_gen_;
+        }
+    }
+}
+#endif /* def WITH_THREADS */
@@ -66,6 +66,53 @@ int compat_strcasecmp(const char *s1, const char *s2);
 //! Case-insensitive string comparison of at most `n` characters.
 int compat_strncasecmp(const char *s1, const char *s2, size_t n);
 
+/* Bit manipulation functions for 64-bit words. */
+
+//! Returns the number of trailing zero bits in `x`, which must be nonzero.
+inline int compat_ctz64(compat_uint64_t x)
+{
+#if __GNUC__ >= 4
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) x >>= 1, ++n;
+    return n;
+#endif
+}
+
+//! Returns the number of leading zero bits in `x`, which must be nonzero.
+inline int compat_clz64(compat_uint64_t x)
+{
+#if __GNUC__ >= 4
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & ((compat_uint64_t)1 << 63))) x <<= 1, ++n;
+    return n;
+#endif
+}
+
+//! Returns the number of set bits in `x`.
+inline int compat_popcount64(compat_uint64_t x)
+{
+#if __GNUC__ >= 4
+    return __builtin_popcountll(x);
+#else
+    int n = 0;
+    for ( ; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+/* Storage class specifier for thread-local variables. */
+#if defined(__GNUC__)
+#define COMPAT_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define COMPAT_THREAD_LOCAL __declspec(thread)
+#else
+#define COMPAT_THREAD_LOCAL
+#endif
+
 /* Figure out which hashtable implementation to use: */
 #if (__cplusplus > 199711L || __GNUC__ >= 4)  /* C++ TR1 supported (GCC 4) */
 #include <tr1/unordered_set>
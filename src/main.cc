@@ -50,6 +50,8 @@
 #ifdef WITH_THREADS
 #include <omp.h>
 #include "ConcurrentRecursiveSolver.h"
+#include "ConcurrentSmallProgressMeasures.h"
+#include "PortfolioSolver.h"
 #endif
 
 #ifdef WITH_MPI
@@ -66,6 +68,8 @@ enum InputFormat {
 };
 
 static InputFormat  arg_input_format          = INPUT_NONE;
+static std::string  arg_input_file            = "";
+static bool         arg_mmap                  = false;
 static std::string  arg_dot_file              = "";
 static std::string  arg_pgsolver_file         = "";
 static std::string  arg_raw_file              = "";
@@ -78,9 +82,18 @@ static std::string  arg_spm_lifting_strategy  = "";
 static int          arg_spm_version           = 0;
 static bool         arg_collect_stats         = false;
 static bool         arg_alternate             = false;
+static SmallProgressMeasuresSolver::Storage arg_spm_storage =
+    SmallProgressMeasuresSolver::STORAGE_DENSE;
+static std::string  arg_checkpoint_file;
+static int          arg_checkpoint_interval   =     600;
+static bool         arg_resume                = false;
+static std::string  arg_warm_start_file;
+static std::string  arg_save_measures_file;
 static bool         arg_decycle               = false;
 static bool         arg_deloop                = false;
 static bool         arg_scc_decomposition     = false;
+static bool         arg_scc_parallel          = false;
+static std::string  arg_portfolio;
 static bool         arg_solve_dual            = false;
 static std::string  arg_reordering;
 static bool         arg_priority_propagation  = false;
@@ -93,6 +106,7 @@ static int          arg_timeout               =       0;
 static bool         arg_verify                = false;
 static bool         arg_zielonka              = false;
 static bool         arg_zielonka_sync         = false;
+static bool         arg_zielonka_inplace      = false;
 static int          arg_threads               = 0;
 static bool         arg_mpi                   = false;
 static int          arg_chunk_size            = -1;
@@ -162,6 +176,8 @@ static void print_usage(const char *argv0)
 "  --outdegree <int>      (random only) average out-degree\n"
 "  --priorities <int>     (random only) number of priorities\n"
 "  --seed <int>           (random only) random number generator seed\n"
+"  --mmap                 (raw only) map input file into memory instead of\n"
+"                         reading it (requires an input file argument)\n"
 "\n"
 "Preprocessing:\n"
 "  --dual                 solve the dual game\n"
@@ -171,16 +187,40 @@ static void print_usage(const char *argv0)
 "  --deloop               detect loops won by the controlling player\n"
 "  --decycle              detect cycles won and controlled by a single player\n"
 "  --scc                  solve strongly connected components individually\n"
+"  --scc-parallel         solve independent components concurrently using\n"
+"                         threads (implies --scc)\n"
+"  --portfolio <list>     run a comma-separated list of solver configurations\n"
+"                         concurrently and use the first solution found; each\n"
+"                         configuration consists of the options -z, --inplace,\n"
+"                         -l <desc>, -L <desc> and -a, written as on the\n"
+"                         command line (e.g. \"-z,-l focuslist -a\")\n"
 "\n"
 "Solving with Small Progress Measures:\n"
 "  --lifting/-l <desc>    Small Progress Measures lifting strategy to use\n"
 "                         ('help' shows available strategies and parameters)\n"
 "  --lifting2/-L <desc>   The same but using the v2 algorithm implementation\n"
 "  --alternate/-a         use Friedmann's two-sided solving approach\n"
+"  --spm-storage <fmt>    progress measure storage: dense (default), sparse\n"
+"                         or pool (shared vectors)\n"
+"  --checkpoint <file>    periodically save progress measures to <file>, and\n"
+"                         when solving is aborted (e.g. by a time-out)\n"
+"  --checkpoint-interval <s>\n"
+"                         seconds between checkpoints (default: 600)\n"
+"  --resume               continue from the checkpoint file, if it exists\n"
+"  --save-measures <file> write final progress measures to <file>\n"
+"  --warm-start <file>    seed progress measures from <file> (as written by\n"
+"                         --save-measures for a similar game)\n"
+"  --threads <count>      lift concurrently using threads (each thread lifts\n"
+"                         vertices from a work list ordered by the lifting\n"
+"                         strategy, which must be linear or predecessor;\n"
+"                         with -a, the normal and dual game are lifted in\n"
+"                         separate threads instead)\n"
 "\n"
 "Solving with Zielonka's recursive algorithm:\n"
 "  --zielonka/-z          use Zielonka's recursive algorithm\n"
-"  --threads <count>      solve concurrently using threads\n"
+"  --inplace              solve subgames in-place instead of copying them\n"
+"  --threads <count>      solve concurrently using threads (not supported with\n"
+"                         --inplace, unless --scc-parallel is given)\n"
 "  --mpi                  solve in parallel using MPI\n"
 "  --chunk/-c <size>      (MPI only) chunk size for partitioning\n"
 "  --sync                 (MPI only) use synchronized MPI algorithm\n"
@@ -265,10 +305,13 @@ static void parse_args(int argc, char *argv[])
         { "outdegree",  required_argument, NULL,  3  },
         { "priorities", required_argument, NULL,  4  },
         { "seed",       required_argument, NULL,  5  },
+        { "mmap",       no_argument,       NULL, 16  },
 
         { "decycle",    no_argument,       NULL,  6  },
         { "deloop",     no_argument,       NULL,  7  },
         { "scc",        no_argument,       NULL,  8  },
+        { "scc-parallel", no_argument,     NULL, 18  },
+        { "portfolio",  required_argument, NULL, 19  },
         { "dual",       no_argument,       NULL,  9  },
         { "reorder",    required_argument, NULL, 10  },
         { "propagate",  no_argument,       NULL, 11  },
@@ -276,8 +319,15 @@ static void parse_args(int argc, char *argv[])
         { "lifting",    required_argument, NULL, 'l' },
         { "lifting2",   required_argument, NULL, 'L' },
         { "alternate",  no_argument,       NULL, 'a' },
+        { "spm-storage",required_argument, NULL, 20  },
+        { "checkpoint", required_argument, NULL, 21  },
+        { "checkpoint-interval", required_argument, NULL, 22 },
+        { "resume",     no_argument,       NULL, 23  },
+        { "save-measures", required_argument, NULL, 24 },
+        { "warm-start", required_argument, NULL, 25  },
 
         { "zielonka",   no_argument,       NULL, 'z' },
+        { "inplace",    no_argument,       NULL, 17  },
         { "threads",    required_argument, NULL, 12  },
         { "mpi",        no_argument,       NULL, 13  },
         { "chunk",      required_argument, NULL, 'c' },
@@ -393,6 +443,10 @@ static void parse_args(int argc, char *argv[])
             arg_random_seed = atoi(optarg);
             break;
 
+        case 16:    /* map raw input file into memory */
+            arg_mmap = true;
+            break;
+
         case 6:     /* remove p-controlled i-cycles when p == i%2 */
             arg_decycle = true;
             break;
@@ -405,6 +459,15 @@ static void parse_args(int argc, char *argv[])
             arg_scc_decomposition = true;
             break;
 
+        case 18:    /* solve strongly connected components concurrently */
+            arg_scc_decomposition = true;
+            arg_scc_parallel = true;
+            break;
+
+        case 19:    /* race a portfolio of solver configurations */
+            arg_portfolio = optarg;
+            break;
+
         case 9:     /* solve dual game */
             arg_solve_dual = true;
             break;
@@ -433,10 +496,56 @@ static void parse_args(int argc, char *argv[])
             arg_alternate = true;
             break;
 
+        case 20:    /* SPM vector storage format */
+            if (strcasecmp(optarg, "dense") == 0)
+            {
+                arg_spm_storage = SmallProgressMeasuresSolver::STORAGE_DENSE;
+            }
+            else
+            if (strcasecmp(optarg, "sparse") == 0)
+            {
+                arg_spm_storage = SmallProgressMeasuresSolver::STORAGE_SPARSE;
+            }
+            else
+            if (strcasecmp(optarg, "pool") == 0)
+            {
+                arg_spm_storage = SmallProgressMeasuresSolver::STORAGE_POOL;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid SPM storage format: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case 21:    /* checkpoint file */
+            arg_checkpoint_file = optarg;
+            break;
+
+        case 22:    /* checkpoint interval (in seconds) */
+            arg_checkpoint_interval = atoi(optarg);
+            break;
+
+        case 23:    /* resume from checkpoint */
+            arg_resume = true;
+            break;
+
+        case 24:    /* save final progress measures */
+            arg_save_measures_file = optarg;
+            break;
+
+        case 25:    /* seed progress measures */
+            arg_warm_start_file = optarg;
+            break;
+
         case 'z':   /* use Zielonka's algorithm instead of SPM */
             arg_zielonka = true;
             break;
 
+        case 17:    /* solve Zielonka subgames in-place */
+            arg_zielonka_inplace = true;
+            break;
+
         case 12:    /* concurrent solving */
             arg_threads = atoi(optarg);
             if (arg_threads < 1)
@@ -537,12 +646,19 @@ static void parse_args(int argc, char *argv[])
         }
         const char *path = argv[optind];
         const char *mode = (input_mode == text) ? "rt" : "r";
-        if (freopen(path, mode, stdin) == NULL)
+        arg_input_file = path;
+        if (!arg_mmap && freopen(path, mode, stdin) == NULL)
         {
             printf("Could not open file \"%s\" for reading!\n", path);
             exit(EXIT_FAILURE);
         }
     }
+
+    if (arg_mmap && (arg_input_format != INPUT_RAW || arg_input_file.empty()))
+    {
+        printf("Memory mapping requires raw input from a file!\n");
+        exit(EXIT_FAILURE);
+    }
 }
 
 /*! Write summary of winners. For each vertex, a single character is printed:
@@ -671,13 +787,19 @@ bool read_input(ParityGame &game)
         return true;
 
     case INPUT_RAW:
+        if (arg_mmap)
+        {
+            Logger::info("Mapping raw input...");
+            game.map_raw(arg_input_file.c_str());
+            return true;
+        }
         Logger::info("Reading raw input...");
         game.read_raw(std::cin);
         return true;
 
     case INPUT_PGSOLVER:
         Logger::info("Reading PGSolver input...");
-        game.read_pgsolver(std::cin);
+        game.read_pgsolver(stdin);
         return !game.empty();
 
     case INPUT_PBES:
@@ -806,6 +928,11 @@ void write_output( const ParityGame &game,
     /* Write hot vertices file */
     if (stats != NULL && !arg_hot_vertices_file.empty())
     {
+        if (!LiftingStatistics::per_vertex())
+        {
+            Logger::warn( "Per-vertex lifting statistics were disabled at "
+                          "compile time (SPM_STATS)" );
+        }
         if (!split(arg_reordering).empty())
         {
             Logger::error("Vertex reordering has distorted vertex indices!");
@@ -883,6 +1010,145 @@ static void set_timeout(int t)
 }
 #endif
 
+#ifdef WITH_THREADS
+/*! Creates a (sequential) solver factory for a portfolio configuration,
+    which is given as a space-separated list of solver options. */
+static ParityGameSolverFactory *create_portfolio_factory(
+    const std::string &config )
+{
+    bool zielonka = false, inplace = false, alternate = false;
+    int spm_version = 0;
+    std::string lifting_strategy;
+
+    // Options are parsed like getopt_long() would: short options may be
+    // grouped, and arguments may be attached or given as the next word.
+    // First, options are normalized to (option character, argument) pairs:
+    std::vector<std::pair<char, std::string> > opts;
+    std::vector<std::string> words = split(config, ' ');
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        const std::string &word = words[i];
+        char opt = 0;
+        std::string arg;
+        bool has_arg = false;
+        if (word.size() > 2 && word[0] == '-' && word[1] == '-')
+        {
+            size_t eq = word.find('=');
+            std::string name = word.substr(2, eq == std::string::npos
+                                              ? std::string::npos : eq - 2);
+            if (name == "zielonka")  opt = 'z';
+            if (name == "inplace")   opt = 'i';
+            if (name == "alternate") opt = 'a';
+            if (name == "lifting")   opt = 'l';
+            if (name == "lifting2")  opt = 'L';
+            if (eq != std::string::npos)
+            {
+                arg = word.substr(eq + 1);
+                has_arg = true;
+                if (opt != 'l' && opt != 'L') opt = 0;
+            }
+        }
+        else
+        if (word.size() > 1 && word[0] == '-')
+        {
+            for (size_t j = 1; j < word.size(); ++j)
+            {
+                opt = word[j];
+                if (opt != 'z' && opt != 'a' && opt != 'l' && opt != 'L')
+                {
+                    opt = 0;
+                    break;
+                }
+                if (opt == 'l' || opt == 'L')
+                {
+                    if (j + 1 < word.size())
+                    {
+                        arg = word.substr(j + 1);
+                        has_arg = true;
+                    }
+                    break;
+                }
+                if (j + 1 < word.size())
+                {
+                    opts.push_back(std::make_pair(opt, std::string()));
+                }
+            }
+        }
+        if (opt == 0)
+        {
+            Logger::fatal( "Invalid option \"%s\" in portfolio configuration "
+                           "\"%s\"", word.c_str(), config.c_str() );
+        }
+        if ((opt == 'l' || opt == 'L') && !has_arg)
+        {
+            if (i + 1 == words.size())
+            {
+                Logger::fatal( "Option \"%s\" requires an argument in "
+                               "portfolio configuration \"%s\"",
+                               word.c_str(), config.c_str() );
+            }
+            arg = words[++i];
+        }
+        opts.push_back(std::make_pair(opt, arg));
+    }
+
+    for (size_t i = 0; i < opts.size(); ++i)
+    {
+        switch (opts[i].first)
+        {
+        case 'z':
+            zielonka = true;
+            break;
+
+        case 'i':
+            inplace = true;
+            break;
+
+        case 'a':
+            alternate = true;
+            break;
+
+        case 'l':
+        case 'L':
+            spm_version = opts[i].first == 'l' ? 1 : 2;
+            lifting_strategy = opts[i].second;
+            break;
+        }
+    }
+
+    if (zielonka == !lifting_strategy.empty())
+    {
+        Logger::fatal( "Portfolio configuration \"%s\" must select exactly "
+                       "one solving algorithm", config.c_str() );
+    }
+
+    if (zielonka)
+    {
+        if (inplace) return new InPlaceRecursiveSolverFactory();
+        return new RecursiveSolverFactory();
+    }
+
+    LiftingStrategyFactory *spm_strategy =
+        LiftingStrategyFactory::create(lifting_strategy);
+    if (!spm_strategy)
+    {
+        Logger::fatal( "Invalid lifting strategy description: %s",
+                       lifting_strategy.c_str() );
+    }
+    if (!spm_strategy->supports_version(spm_version))
+    {
+        Logger::fatal( "Lifting strategy does not SPM version %d. "
+                        "(Try %s %s instead.)", spm_version,
+                        spm_version == 1 ? "-L" : "-l",
+                        lifting_strategy.c_str() );
+    }
+    ParityGameSolverFactory *result = new SmallProgressMeasuresSolverFactory(
+        spm_strategy, spm_version, alternate, NULL );
+    spm_strategy->deref();
+    return result;
+}
+#endif
+
 //! Application entry point.
 int main(int argc, char *argv[])
 {
@@ -930,7 +1196,8 @@ int main(int argc, char *argv[])
 
     bool failed = true;
 
-    if (arg_spm_lifting_strategy.empty() && !arg_zielonka)
+    if (arg_spm_lifting_strategy.empty() && !arg_zielonka &&
+        arg_portfolio.empty())
     {
         // Don't solve; just convert data.
         write_output(game);
@@ -956,6 +1223,18 @@ int main(int argc, char *argv[])
         if (arg_mpi) Logger::fatal("MPI support was not compiled in!");
 #endif
 
+        if (arg_scc_parallel)
+        {
+#ifndef WITH_THREADS
+            Logger::fatal("Thread support was not compiled in!");
+#endif
+            if (arg_mpi)
+            {
+                Logger::fatal( "Parallel component solving does not support "
+                               "MPI (option --mpi)" );
+            }
+        }
+
 #ifdef WITH_MPI
         VertexPartition *vpart = NULL;
         if (arg_mpi)
@@ -971,7 +1250,8 @@ int main(int argc, char *argv[])
         // Create appropriate solver factory:
         std::auto_ptr<ParityGameSolverFactory> solver_factory;
 
-        if (arg_zielonka && !arg_spm_lifting_strategy.empty())
+        if ( (arg_zielonka + !arg_spm_lifting_strategy.empty() +
+              !arg_portfolio.empty()) > 1 )
         {
             Logger::fatal("Multiple solving algorithms selected!\n");
         }
@@ -987,6 +1267,32 @@ int main(int argc, char *argv[])
                             arg_spm_lifting_strategy.c_str());
             Logger::message("## config.spm.count_lifts = %s",
                             bool_to_string(arg_collect_stats));
+            Logger::message("## config.spm.stats_policy = %s",
+                            SPM_STATS == SPM_STATS_OFF     ? "off" :
+                            SPM_STATS == SPM_STATS_GLOBAL  ? "global" :
+                            SPM_STATS == SPM_STATS_SAMPLED ? "sampled" :
+                                                             "full" );
+            Logger::message("## config.spm.vector_kernels = %s",
+                            vector_kernels_isa());
+            Logger::message("## config.spm.storage = %s",
+                arg_spm_storage == SmallProgressMeasuresSolver::STORAGE_SPARSE
+                    ? "sparse" :
+                arg_spm_storage == SmallProgressMeasuresSolver::STORAGE_POOL
+                    ? "pool" : "dense" );
+            if (!arg_checkpoint_file.empty())
+            {
+                Logger::message("## config.spm.checkpoint = %s",
+                                arg_checkpoint_file.c_str());
+                Logger::message("## config.spm.checkpoint_interval = %d s",
+                                arg_checkpoint_interval);
+                Logger::message("## config.spm.resume = %s",
+                                bool_to_string(arg_resume));
+            }
+            if (!arg_warm_start_file.empty())
+            {
+                Logger::message("## config.spm.warm_start = %s",
+                                arg_warm_start_file.c_str());
+            }
 
             LiftingStrategyFactory *spm_strategy = 
                 LiftingStrategyFactory::create(arg_spm_lifting_strategy);
@@ -1007,13 +1313,74 @@ int main(int argc, char *argv[])
 
             if (arg_collect_stats)
             {
+                if (SPM_STATS == SPM_STATS_OFF)
+                {
+                    Logger::warn( "Lifting statistics were disabled at "
+                                  "compile time (SPM_STATS)%s",
+                                  arg_max_lifts >= 0 ? "; only the total is "
+                                  "counted, to enforce --maxlifts" : "" );
+                }
                 stats.reset(new LiftingStatistics(game, arg_max_lifts));
             }
 
             if (!arg_mpi)
             {
-                solver_factory.reset(new SmallProgressMeasuresSolverFactory(
-                    spm_strategy, arg_spm_version, arg_alternate, stats.get() ));
+                if (!arg_threads || arg_scc_parallel || arg_alternate)
+                {
+                    // With threads and -a, lift the normal and dual game
+                    // concurrently (which does not support checkpoints):
+                    bool parallel = arg_threads && !arg_scc_parallel;
+                    if (parallel && !arg_checkpoint_file.empty())
+                    {
+                        Logger::warn( "Checkpointing disables concurrent "
+                                      "lifting of the normal and dual game" );
+                        parallel = false;
+                    }
+                    SmallProgressMeasuresSolverFactory *spm_factory =
+                        new SmallProgressMeasuresSolverFactory(
+                            spm_strategy, arg_spm_version, arg_alternate,
+                            stats.get(), arg_spm_storage, parallel );
+                    if (!arg_checkpoint_file.empty())
+                    {
+                        spm_factory->set_checkpoint( arg_checkpoint_file,
+                            arg_checkpoint_interval, arg_resume );
+                    }
+                    spm_factory->set_warm_start( arg_warm_start_file,
+                                                 arg_save_measures_file );
+                    solver_factory.reset(spm_factory);
+                }
+#ifdef WITH_THREADS
+                else
+                {
+                    if (!arg_checkpoint_file.empty())
+                    {
+                        Logger::warn( "Concurrent SPM solver does not support "
+                                      "checkpoints" );
+                    }
+                    if ( !arg_warm_start_file.empty() ||
+                         !arg_save_measures_file.empty() )
+                    {
+                        Logger::warn( "Concurrent SPM solver does not support "
+                                      "warm starting" );
+                    }
+                    if (!ConcurrentSmallProgressMeasuresSolverFactory::
+                            supports(spm_strategy))
+                    {
+                        Logger::fatal( "Concurrent SPM solver supports only "
+                                       "the linear and predecessor lifting "
+                                       "strategies" );
+                    }
+                    if ( arg_spm_storage !=
+                            SmallProgressMeasuresSolver::STORAGE_DENSE )
+                    {
+                        Logger::warn( "Concurrent SPM solver only supports "
+                                      "dense storage" );
+                    }
+                    solver_factory.reset(
+                        new ConcurrentSmallProgressMeasuresSolverFactory(
+                            spm_strategy, stats.get() ));
+                }
+#endif
             }
 #ifdef WITH_MPI
             else
@@ -1027,6 +1394,21 @@ int main(int argc, char *argv[])
                 {
                     Logger::fatal("MPI SPM solver only supports SPM version 1");
                 }
+                if (arg_spm_storage != SmallProgressMeasuresSolver::STORAGE_DENSE)
+                {
+                    Logger::fatal("MPI SPM solver only supports dense storage");
+                }
+                if (!arg_checkpoint_file.empty())
+                {
+                    Logger::fatal( "MPI SPM solver does not support "
+                                   "checkpoints" );
+                }
+                if ( !arg_warm_start_file.empty() ||
+                     !arg_save_measures_file.empty() )
+                {
+                    Logger::fatal( "MPI SPM solver does not support "
+                                   "warm starting" );
+                }
                 solver_factory.reset(new MpiSpmSolverFactory(
                     spm_strategy, vpart, stats.get() ));
             }
@@ -1040,13 +1422,29 @@ int main(int argc, char *argv[])
             Logger::message("## config.solver = zielonka");
             if (!arg_mpi)
             {
-                if (!arg_threads)
+                if (!arg_threads || arg_scc_parallel)
                 {
-                    solver_factory.reset(new RecursiveSolverFactory());
+                    Logger::message("## config.inplace = %s",
+                                    bool_to_string(arg_zielonka_inplace));
+                    if (arg_zielonka_inplace)
+                    {
+                        solver_factory.reset(
+                            new InPlaceRecursiveSolverFactory() );
+                    }
+                    else
+                    {
+                        solver_factory.reset(new RecursiveSolverFactory());
+                    }
                 }
 #ifdef WITH_THREADS
                 else
                 {
+                    if (arg_zielonka_inplace)
+                    {
+                        Logger::fatal( "Concurrent recursive solver does not "
+                                       "support in-place solving (use "
+                                       "--scc-parallel with --inplace)" );
+                    }
                     solver_factory.reset(new ConcurrentRecursiveSolverFactory());
                 }
 #endif
@@ -1060,6 +1458,38 @@ int main(int argc, char *argv[])
 #endif
         }
 
+        // Create portfolio solver factory if requested:
+        if (!arg_portfolio.empty())
+        {
+            Logger::message("## config.solver = portfolio");
+            Logger::message("## config.portfolio = %s", arg_portfolio.c_str());
+#ifndef WITH_THREADS
+            Logger::fatal("Thread support was not compiled in!");
+#else
+            if (arg_mpi)
+            {
+                Logger::fatal( "Portfolio solver does not support MPI "
+                               "(option --mpi)" );
+            }
+            if (arg_collect_stats)
+            {
+                Logger::fatal( "Portfolio solver does not support lifting "
+                               "statistics (option -S)" );
+            }
+            std::vector<std::string> configs = split(arg_portfolio);
+            std::vector<ParityGameSolverFactory*> factories;
+            for (size_t i = 0; i < configs.size(); ++i)
+            {
+                factories.push_back(create_portfolio_factory(configs[i]));
+            }
+            solver_factory.reset(new PortfolioSolverFactory(factories));
+            for (size_t i = 0; i < factories.size(); ++i)
+            {
+                factories[i]->deref();
+            }
+#endif
+        }
+
 #ifdef WITH_MPI
         if (vpart)
         {
@@ -1134,7 +1564,7 @@ int main(int argc, char *argv[])
             edgei old_edges = game.graph().E();
             SmallProgressMeasuresSolver::preprocess_game(game);
             edgei rem_edges = old_edges - game.graph().E();
-            Logger::info("Removed %d edge%s...", rem_edges, rem_edges == 1 ? "" : "s");
+            Logger::info("Removed %ld edge%s...", (long)rem_edges, rem_edges == 1 ? "" : "s");
         }
 
         /* Note: priority propagation is done after preprocessing, because
@@ -1161,7 +1591,7 @@ int main(int argc, char *argv[])
             for (int p = 0; p < game.d(); ++p)
             {
                 verti count = game.cardinality(p);
-                Logger::info("  %2d occurs %d times", p, count);
+                Logger::info("  %2d occurs %ld times", p, (long)count);
                 sum += (long long)p*count;
             }
             Logger::message( "## game.average_priority = %.10lf",
@@ -1200,10 +1630,12 @@ int main(int argc, char *argv[])
         */
         Logger::message( "## config.decompose = %s",
                          bool_to_string(arg_scc_decomposition) );
+        Logger::message( "## config.decompose_parallel = %s",
+                         bool_to_string(arg_scc_parallel) );
         if (arg_scc_decomposition)
         {
-            solver_factory.reset(
-                new ComponentSolverFactory(*solver_factory.release()) );
+            solver_factory.reset( new ComponentSolverFactory(
+                *solver_factory.release(), 10, arg_scc_parallel ) );
         }
         Logger::message( "## config.decycle = %s",
                          bool_to_string(arg_decycle) );
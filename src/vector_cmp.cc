@@ -0,0 +1,189 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "vector_cmp.h"
+
+/* Vectorized kernels require GCC 4.9 (or a compatible compiler) for function
+   specific target options and runtime detection of processor features. */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define VECTOR_CMP_X86
+#include <immintrin.h>
+#endif
+
+static int ext_scalar( const verti *const vecs[], int n, int N,
+                       bool take_max )
+{
+    int res = 0;
+    for (int i = 1; i < n; ++i)
+    {
+        int d = vector_cmp_scalar(vecs[i], vecs[res], N);
+        if (take_max ? d > 0 : d < 0) res = i;
+    }
+    return res;
+}
+
+static int cmp_scalar(const verti vec1[], const verti vec2[], int N)
+{
+    return vector_cmp_scalar(vec1, vec2, N);
+}
+
+#ifdef VECTOR_CMP_X86
+
+/* The kernels below find the first differing component by comparing blocks
+   of components for equality, and then compare that component only. The
+   vectors are never read beyond their `N`th component: SSE kernels compare
+   the remaining components one by one, and AVX2 kernels use masked loads. */
+
+#ifdef WITH_64BIT_INDICES
+#define SSE_CMPEQ       _mm_cmpeq_epi64
+#define AVX_CMPEQ       _mm256_cmpeq_epi64
+#define AVX_MASKLOAD(p, m) _mm256_maskload_epi64((const long long*)(p), (m))
+#else
+#define SSE_CMPEQ       _mm_cmpeq_epi32
+#define AVX_CMPEQ       _mm256_cmpeq_epi32
+#define AVX_MASKLOAD(p, m) _mm256_maskload_epi32((const int*)(p), (m))
+#endif
+
+__attribute__((target("sse4.2")))
+static inline int cmp_sse_inline(const verti vec1[], const verti vec2[], int N)
+{
+    if (vec1[0] == NO_VERTEX) return vec2[0] == NO_VERTEX ? 0 : +1;
+    if (vec2[0] == NO_VERTEX) return -1;
+
+    const int lanes = 16/sizeof(verti);
+    int n = 0;
+    for ( ; n + lanes <= N; n += lanes)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(vec1 + n)),
+                b = _mm_loadu_si128((const __m128i*)(vec2 + n));
+        unsigned diff = ~_mm_movemask_epi8(SSE_CMPEQ(a, b)) & 0xffffu;
+        if (diff != 0)
+        {
+            int i = n + __builtin_ctz(diff)/sizeof(verti);
+            return vec1[i] < vec2[i] ? -1 : +1;
+        }
+    }
+    for ( ; n < N; ++n)
+    {
+        if (vec1[n] != vec2[n]) return vec1[n] < vec2[n] ? -1 : +1;
+    }
+    return 0;
+}
+
+__attribute__((target("avx2")))
+static inline int cmp_avx2_inline(const verti vec1[], const verti vec2[], int N)
+{
+    if (vec1[0] == NO_VERTEX) return vec2[0] == NO_VERTEX ? 0 : +1;
+    if (vec2[0] == NO_VERTEX) return -1;
+
+    const int lanes = 32/sizeof(verti);
+    int n = 0;
+    for ( ; n + lanes <= N; n += lanes)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(vec1 + n)),
+                b = _mm256_loadu_si256((const __m256i*)(vec2 + n));
+        unsigned diff = ~(unsigned)_mm256_movemask_epi8(AVX_CMPEQ(a, b));
+        if (diff != 0)
+        {
+            int i = n + __builtin_ctz(diff)/sizeof(verti);
+            return vec1[i] < vec2[i] ? -1 : +1;
+        }
+    }
+    if (n < N)
+    {
+        // Compare the remaining components with a masked load (masked out
+        // components are zero in both vectors).
+        const int k = N - n;
+#ifdef WITH_64BIT_INDICES
+        __m256i mask = _mm256_cmpgt_epi64( _mm256_set1_epi64x(k),
+                                           _mm256_set_epi64x(3, 2, 1, 0) );
+#else
+        __m256i mask = _mm256_cmpgt_epi32( _mm256_set1_epi32(k),
+                                _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0) );
+#endif
+        __m256i a = AVX_MASKLOAD(vec1 + n, mask),
+                b = AVX_MASKLOAD(vec2 + n, mask);
+        unsigned diff = ~(unsigned)_mm256_movemask_epi8(AVX_CMPEQ(a, b));
+        if (diff != 0)
+        {
+            int i = n + __builtin_ctz(diff)/sizeof(verti);
+            return vec1[i] < vec2[i] ? -1 : +1;
+        }
+    }
+    return 0;
+}
+
+__attribute__((target("sse4.2")))
+static int cmp_sse(const verti vec1[], const verti vec2[], int N)
+{
+    return cmp_sse_inline(vec1, vec2, N);
+}
+
+__attribute__((target("sse4.2")))
+static int ext_sse(const verti *const vecs[], int n, int N, bool take_max)
+{
+    int res = 0;
+    for (int i = 1; i < n; ++i)
+    {
+        int d = cmp_sse_inline(vecs[i], vecs[res], N);
+        if (take_max ? d > 0 : d < 0) res = i;
+    }
+    return res;
+}
+
+__attribute__((target("avx2")))
+static int cmp_avx2(const verti vec1[], const verti vec2[], int N)
+{
+    return cmp_avx2_inline(vec1, vec2, N);
+}
+
+__attribute__((target("avx2")))
+static int ext_avx2(const verti *const vecs[], int n, int N, bool take_max)
+{
+    int res = 0;
+    for (int i = 1; i < n; ++i)
+    {
+        int d = cmp_avx2_inline(vecs[i], vecs[res], N);
+        if (take_max ? d > 0 : d < 0) res = i;
+    }
+    return res;
+}
+
+#endif /* def VECTOR_CMP_X86 */
+
+//! Instruction set supported by the host processor.
+enum VectorIsa { ISA_SCALAR, ISA_SSE42, ISA_AVX2 };
+
+static VectorIsa detect_isa()
+{
+#ifdef VECTOR_CMP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return ISA_SSE42;
+#endif
+    return ISA_SCALAR;
+}
+
+static const VectorIsa isa = detect_isa();
+
+#ifdef VECTOR_CMP_X86
+vector_cmp_kernel vector_cmp_best =
+    isa == ISA_AVX2 ? cmp_avx2 : isa == ISA_SSE42 ? cmp_sse : cmp_scalar;
+vector_ext_kernel vector_ext_best =
+    isa == ISA_AVX2 ? ext_avx2 : isa == ISA_SSE42 ? ext_sse : ext_scalar;
+#else
+vector_cmp_kernel vector_cmp_best = cmp_scalar;
+vector_ext_kernel vector_ext_best = ext_scalar;
+#endif
+
+const char *vector_kernels_isa()
+{
+    return isa == ISA_AVX2 ? "avx2" : isa == ISA_SSE42 ? "sse4.2" : "scalar";
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2009-2013 University of Twente
+// Copyright (c) 2009-2013 Michael Weber <michaelw@cs.utwente.nl>
+// Copyright (c) 2009-2013 Maks Verver <maksverver@geocities.com>
+// Copyright (c) 2009-2013 Eindhoven University of Technology
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+/*! \file vector_cmp.h
+    \brief Comparison kernels for progress measure vectors.
+
+    Progress measure vectors are arrays of `verti` components that are
+    compared lexicographically, except that a vector with NO_VERTEX as its
+    first component represents top, which is greater than all other vectors
+    (regardless of the remaining components).
+
+    Besides the scalar comparison below, vectorized kernels are provided for
+    x86 processors supporting SSE4.2 or AVX2; the best kernel supported by the
+    host processor is selected at startup. SmallProgressMeasures uses the
+    selected kernels for vectors of at least
+    SmallProgressMeasures::ext_kernel_min_len components, and the inline
+    scalar comparison for shorter ones.
+
+    FixedDenseSPM stores short vectors with narrower components instead, which
+    are compared by vector_cmp_fixed(). Calling the selected kernels through a
+    pointer costs more than it gains for such short vectors, so that function
+    is inlined and uses only SSE2, which every x86-64 processor supports.
+*/
+
+#ifndef VECTOR_CMP_H_INCLUDED
+#define VECTOR_CMP_H_INCLUDED
+
+#include "Graph.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*! Compares the first `N` components of the progress measure vectors `vec1`
+    and `vec2`, and returns -1, 0 or 1 to indicate that `vec1` is smaller
+    than, equal to, or larger than `vec2` (respectively). */
+inline int vector_cmp_scalar(const verti vec1[], const verti vec2[], int N)
+{
+    if (vec1[0] == NO_VERTEX) return vec2[0] == NO_VERTEX ? 0 : +1;
+    if (vec2[0] == NO_VERTEX) return -1;
+
+    for (int n = 0; n < N; ++n)
+    {
+        if (vec1[n] < vec2[n]) return -1;
+        if (vec1[n] > vec2[n]) return +1;
+    }
+
+    return 0;
+}
+
+//! Type of kernels that compare two vectors like vector_cmp_scalar().
+typedef int (*vector_cmp_kernel)(const verti vec1[], const verti vec2[], int N);
+
+/*! Type of kernels that return the index of the first maximal (if `take_max`
+    is true) or minimal (otherwise) vector among the `n` > 0 given vectors,
+    comparing their first `N` components. */
+typedef int (*vector_ext_kernel)( const verti *const vecs[], int n, int N,
+                                  bool take_max );
+
+//! Vector comparison kernel selected for the host processor.
+extern vector_cmp_kernel vector_cmp_best;
+
+//! Extremum kernel selected for the host processor.
+extern vector_ext_kernel vector_ext_best;
+
+/*! Number of bytes that vector_cmp_fixed() may read past the end of the
+    given vectors. */
+static const int vector_fixed_padding = 16;
+
+/*! Compares the first `N` components of the progress measure vectors `vec1`
+    and `vec2` of at most `MaxLen` components stored as integers of type `T`,
+    like vector_cmp_scalar(). A vector with the maximum value of `T` as its
+    first component represents top.
+
+    With SSE2, the vectors are compared in blocks of 16 bytes for equality
+    (the first differing byte lies in the first differing component, whatever
+    the component type), so up to vector_fixed_padding bytes beyond the `N`th
+    component may be read, but these do not affect the result. */
+template<int MaxLen, class T>
+inline int vector_cmp_fixed(const T vec1[], const T vec2[], int N)
+{
+    if (vec1[0] == (T)-1) return vec2[0] == (T)-1 ? 0 : +1;
+    if (vec2[0] == (T)-1) return -1;
+
+#ifdef __SSE2__
+    const int bytes = N*sizeof(T);
+    for (int b = 0; b < MaxLen*(int)sizeof(T) && b < bytes; b += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)((const char*)vec1 + b)),
+                y = _mm_loadu_si128((const __m128i*)((const char*)vec2 + b));
+        unsigned diff = ~_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) & 0xffffu;
+        if (bytes - b < 16) diff &= (1u << (bytes - b)) - 1;
+        if (diff != 0)
+        {
+            int i = (b + __builtin_ctz(diff))/sizeof(T);
+            return vec1[i] < vec2[i] ? -1 : +1;
+        }
+    }
+#else
+    for (int n = 0; n < MaxLen && n < N; ++n)
+    {
+        if (vec1[n] != vec2[n]) return vec1[n] < vec2[n] ? -1 : +1;
+    }
+#endif
+    return 0;
+}
+
+/*! Returns the name of the instruction set used by the selected kernels:
+    "avx2", "sse4.2" or "scalar". */
+const char *vector_kernels_isa();
+
+#endif /* ndef VECTOR_CMP_H_INCLUDED */